@@ -0,0 +1,71 @@
+#ifndef _BENCH_H
+#define _BENCH_H
+
+// Microbenchmarks for the host build, in the style of Google Benchmark
+//
+//     static void BM_name( BENCH_STATE *st )
+//     {
+//         ... set up ...
+//         while ( bench_keep_running( st ) ) {
+//             ... the code to time ...
+//         }
+//         bench_set_bytes( st, bytes per iteration );		// optional, adds a bytes/s column
+//     }
+//     BENCHMARK( BM_name );
+//
+// - bench_main.c runs each one with more iterations until it takes at least the minimum time
+// - only the time from the first bench_keep_running() to the one returning 0 is counted, less
+//   any time between bench_pause() and bench_resume()
+// - bench_counter() adds a column with a total divided by the iterations, e.g. the MOS calls
+//   made (host_stats) - on the Agon each costs far more than it does here, so they matter as
+//   much as the time
+// - plain C types only, as the benchmarks are built against the toolchain headers and
+//   bench_main.c against the host's (see host_io.h)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_COUNTERS		4
+
+typedef struct {
+	long iterations;
+	long left;
+	int running;
+	unsigned long long start;
+	unsigned long long ns;
+	double bytes;
+	int counters;
+	const char *counter_name[BENCH_COUNTERS];
+	double counter[BENCH_COUNTERS];
+} BENCH_STATE;
+
+typedef void (*BENCH_FN)( BENCH_STATE *st );
+
+void bench_register( const char *name, BENCH_FN fn );
+void bench_pause( BENCH_STATE *st );
+void bench_resume( BENCH_STATE *st );
+void bench_set_bytes( BENCH_STATE *st, double bytes );
+void bench_counter( BENCH_STATE *st, const char *name, double total );
+
+static inline int bench_keep_running( BENCH_STATE *st )
+{
+	if ( st->left > 0 ) {
+		if ( !st->running ) bench_resume( st );
+		st->left--;
+		return 1;
+	}
+	bench_pause( st );
+	return 0;
+}
+
+// Stop the compiler from removing a result that isn't used
+#define bench_use( p )		__asm__ volatile( "" : : "g"( p ) : "memory" )
+
+#define BENCHMARK( fn )		static void __attribute__(( constructor )) fn##_register( void ) { bench_register( #fn, fn ); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
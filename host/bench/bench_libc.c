@@ -0,0 +1,246 @@
+/*
+ * Title:			bench_libc - microbenchmarks of the library code in the host build
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+// The "mos" column is the MOS calls (including putch / outchar) per iteration, and "vdu" the
+// bytes sent to the VDP - see bench.h
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <vdp_vdu.h>
+#include <vdp_key.h>
+#include "host_shim.h"
+#include "bench.h"
+
+#define BENCH_FILE		"bench.tmp"
+#define BLOCK			256
+#define LINES			64
+
+int remove( const char *filename );		// remove.c - not declared in stdio.h
+void rewind( FILE *stream );			// rewind.c - likewise
+
+static HOST_STATS stats_start;
+
+static void stats_begin( void )
+{
+	host_vdu_echo( false );
+	stats_start = host_stats;
+}
+
+static void stats_end( BENCH_STATE *st )
+{
+	bench_counter( st, "mos", host_stats.mos_calls - stats_start.mos_calls );
+	if ( host_stats.vdu_bytes != stats_start.vdu_bytes ) bench_counter( st, "vdu", host_stats.vdu_bytes - stats_start.vdu_bytes );
+	host_vdu_echo( true );
+}
+
+// printf
+
+static void BM_snprintf_int( BENCH_STATE *st )
+{
+	char buf[32];
+	int i = 0;
+
+	while ( bench_keep_running( st ) ) {
+		snprintf( buf, sizeof( buf ), "%d", i++ );
+		bench_use( buf );
+	}
+}
+BENCHMARK( BM_snprintf_int );
+
+static void BM_snprintf_mixed( BENCH_STATE *st )
+{
+	char buf[64];
+	int i = 0;
+
+	while ( bench_keep_running( st ) ) {
+		snprintf( buf, sizeof( buf ), "%-8s %5d %04x %c|", "score", i, i, 'A' + ( i & 15 ) );
+		i++;
+		bench_use( buf );
+	}
+}
+BENCHMARK( BM_snprintf_mixed );
+
+static void BM_snprintf_float( BENCH_STATE *st )
+{
+	char buf[32];
+	float f = 0.0f;
+
+	while ( bench_keep_running( st ) ) {
+		snprintf( buf, sizeof( buf ), "%.3f", f );
+		f += 1.25f;
+		bench_use( buf );
+	}
+}
+BENCHMARK( BM_snprintf_float );
+
+// printf to the console - one outchar per character
+
+static void BM_printf_console( BENCH_STATE *st )
+{
+	int i = 0;
+
+	stats_begin();
+	while ( bench_keep_running( st ) ) {
+		printf( "Frame %5d score %6d\n", i, i * 10 );
+		i++;
+	}
+	stats_end( st );
+}
+BENCHMARK( BM_printf_console );
+
+// Files
+
+static void BM_fputc_file( BENCH_STATE *st )
+{
+	FILE *f = fopen( BENCH_FILE, "wb" );
+	int i;
+
+	stats_begin();
+	while ( bench_keep_running( st ) ) {
+		for ( i = 0; i < BLOCK; i++ ) fputc( i, f );
+	}
+	stats_end( st );
+	bench_set_bytes( st, BLOCK );
+	fclose( f );
+	remove( BENCH_FILE );
+}
+BENCHMARK( BM_fputc_file );
+
+static void BM_fwrite_file( BENCH_STATE *st )
+{
+	static char block[BLOCK];
+	FILE *f = fopen( BENCH_FILE, "wb" );
+
+	stats_begin();
+	while ( bench_keep_running( st ) ) fwrite( block, 1, BLOCK, f );
+	stats_end( st );
+	bench_set_bytes( st, BLOCK );
+	fclose( f );
+	remove( BENCH_FILE );
+}
+BENCHMARK( BM_fwrite_file );
+
+// Reads LINES lines of text with CR/LF translation
+
+static void BM_fgets_text( BENCH_STATE *st )
+{
+	char line[64];
+	FILE *f = fopen( BENCH_FILE, "w" );
+	long bytes;
+	int i;
+
+	for ( i = 0; i < LINES; i++ ) fprintf( f, "%d,sprite%d,%d,%d\n", i, i, i * 3, i * 7 );
+	fclose( f );
+
+	f = fopen( BENCH_FILE, "r" );
+	stats_begin();
+	while ( bench_keep_running( st ) ) {
+		rewind( f );
+		while ( fgets( line, sizeof( line ), f ) ) bench_use( line );
+	}
+	stats_end( st );
+	bytes = ftell( f );
+	bench_set_bytes( st, bytes );
+	fclose( f );
+	remove( BENCH_FILE );
+}
+BENCHMARK( BM_fgets_text );
+
+// strtok and time
+
+static void BM_strtok( BENCH_STATE *st )
+{
+	static const char csv[] = "12,sprite12,36,84,enemy,1,0,255";
+	char buf[sizeof( csv )];
+	char *t;
+
+	while ( bench_keep_running( st ) ) {
+		memcpy( buf, csv, sizeof( csv ) );
+		for ( t = strtok( buf, "," ); t; t = strtok( NULL, "," ) ) bench_use( t );
+	}
+}
+BENCHMARK( BM_strtok );
+
+static void BM_mktime( BENCH_STATE *st )
+{
+	struct tm tm = { .tm_year = 124, .tm_mon = 9, .tm_mday = 18, .tm_hour = 12 };
+	time_t t;
+
+	while ( bench_keep_running( st ) ) {
+		t = mktime( &tm );
+		bench_use( t );
+	}
+}
+BENCHMARK( BM_mktime );
+
+static void BM_gmtime( BENCH_STATE *st )
+{
+	time_t t = 1729252800;
+	struct tm *tm;
+
+	while ( bench_keep_running( st ) ) {
+		tm = gmtime( &t );
+		t += 3607;
+		bench_use( tm );
+	}
+}
+BENCHMARK( BM_gmtime );
+
+// VDU - 64 points a frame, one mos_puts each or batched, and all off screen (dropped)
+
+static void plot_frame( int x0 )
+{
+	int i;
+
+	for ( i = 0; i < 64; i++ ) vdp_point( x0 + i * 16, i * 8 );
+}
+
+static void BM_vdp_point( BENCH_STATE *st )
+{
+	stats_begin();
+	while ( bench_keep_running( st ) ) plot_frame( 0 );
+	stats_end( st );
+}
+BENCHMARK( BM_vdp_point );
+
+static void BM_vdp_point_batched( BENCH_STATE *st )
+{
+	static char batch[512];
+
+	stats_begin();
+	while ( bench_keep_running( st ) ) {
+		vdp_batch_begin( batch, sizeof( batch ) );
+		plot_frame( 0 );
+		vdp_batch_end();
+	}
+	stats_end( st );
+}
+BENCHMARK( BM_vdp_point_batched );
+
+static void BM_vdp_point_clipped( BENCH_STATE *st )
+{
+	vdp_get_scr_dims( true );
+	vdp_clip_enable( true );
+	stats_begin();
+	while ( bench_keep_running( st ) ) plot_frame( 2000 );
+	stats_end( st );
+	vdp_clip_enable( false );
+}
+BENCHMARK( BM_vdp_point_clipped );
+
+static void BM_kb_scan( BENCH_STATE *st )
+{
+	host_key( KB_KEY_SPACE, true );
+	while ( bench_keep_running( st ) ) {
+		kb_Scan();
+		bench_use( kb_IsDown( KB_KEY_SPACE ) );
+	}
+	host_key( KB_KEY_SPACE, false );
+}
+BENCHMARK( BM_kb_scan );
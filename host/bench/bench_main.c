@@ -0,0 +1,105 @@
+// Runner for the host build microbenchmarks - see bench.h
+//
+// usage: host-bench [--benchmark_filter=TEXT] [--benchmark_min_time=SECONDS]
+//
+// Runs the benchmarks whose names contain TEXT (all by default), each for at least 0.5s.
+
+#include "bench.h"
+#include "host_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_MAX			64
+#define BENCH_MAX_ITERS		1000000000L
+
+static struct {
+	const char *name;
+	BENCH_FN fn;
+} benches[BENCH_MAX];
+static int bench_count;
+
+void bench_register( const char *name, BENCH_FN fn )
+{
+	if ( bench_count == BENCH_MAX ) return;
+	benches[bench_count].name = name;
+	benches[bench_count].fn = fn;
+	bench_count++;
+}
+
+void bench_pause( BENCH_STATE *st )
+{
+	if ( !st->running ) return;
+	st->ns += hio_ns() - st->start;
+	st->running = 0;
+}
+
+void bench_resume( BENCH_STATE *st )
+{
+	if ( st->running ) return;
+	st->start = hio_ns();
+	st->running = 1;
+}
+
+void bench_set_bytes( BENCH_STATE *st, double bytes )
+{
+	st->bytes = bytes;
+}
+
+void bench_counter( BENCH_STATE *st, const char *name, double total )
+{
+	int i;
+
+	for ( i = 0; i < st->counters && strcmp( st->counter_name[i], name ); i++ );
+	if ( i == BENCH_COUNTERS ) return;
+	if ( i == st->counters ) st->counters++;
+	st->counter_name[i] = name;
+	st->counter[i] = total;
+}
+
+// Run with more iterations until it takes min_ns, aiming a little over so it's done next time
+
+static void run( const char *name, BENCH_FN fn, unsigned long long min_ns )
+{
+	BENCH_STATE st;
+	long n = 1;
+	int i;
+
+	for ( ;; ) {
+		memset( &st, 0, sizeof( st ) );
+		st.iterations = st.left = n;
+		fn( &st );
+		if ( st.ns >= min_ns || n >= BENCH_MAX_ITERS ) break;
+		if ( st.ns < min_ns / 100 ) n *= 100;
+		else n = (long)( n * 1.4 * min_ns / st.ns ) + 1;
+		if ( n > BENCH_MAX_ITERS ) n = BENCH_MAX_ITERS;
+	}
+
+	printf( "%-32s %12.1f ns %12ld", name, (double)st.ns / n, n );
+	if ( st.bytes ) printf( "  %.1fMB/s", st.bytes * n * 1e3 / st.ns );
+	for ( i = 0; i < st.counters; i++ ) printf( "  %s=%g", st.counter_name[i], st.counter[i] / n );
+	printf( "\n" );
+	fflush( stdout );
+}
+
+int main( int argc, char *argv[] )
+{
+	const char *filter = "";
+	double min_time = 0.5;
+	int i;
+
+	for ( i = 1; i < argc; i++ ) {
+		if ( !strncmp( argv[i], "--benchmark_filter=", 19 ) ) filter = argv[i] + 19;
+		else if ( !strncmp( argv[i], "--benchmark_min_time=", 21 ) ) min_time = atof( argv[i] + 21 );
+		else {
+			fprintf( stderr, "usage: %s [--benchmark_filter=TEXT] [--benchmark_min_time=SECONDS]\n", argv[0] );
+			return 1;
+		}
+	}
+
+	printf( "%-32s %15s %12s  %s\n", "Benchmark", "Time", "Iterations", "Counters (per iteration)" );
+	for ( i = 0; i < bench_count; i++ ) {
+		if ( strstr( benches[i].name, filter ) ) run( benches[i].name, benches[i].fn, min_time * 1e9 );
+	}
+	return 0;
+}
@@ -0,0 +1,105 @@
+// Stand in for libFuzzer, for hosts without clang - runs LLVMFuzzerTestOneInput on random inputs
+//
+// usage: fuzz-NAME [-runs=N] [-seed=N] [-max_len=N] [FILE ...]
+//
+// - with files, runs each one (e.g. a crash file to reproduce it), otherwise N random inputs
+// - if an input crashes (a harness finds a difference, or a sanitizer error), it's written to
+//   crash-SEED-RUN before the program stops, for rerunning under a debugger
+// - the same harnesses link with libFuzzer for coverage guided fuzzing (FUZZER=libfuzzer)
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int LLVMFuzzerTestOneInput( const uint8_t *data, size_t size );
+
+static uint8_t *input;
+static size_t input_len;
+static char crash_name[64];
+
+static void crashed( int sig )
+{
+	FILE *f = fopen( crash_name, "wb" );
+
+	if ( f ) {
+		fwrite( input, 1, input_len, f );
+		fclose( f );
+		fprintf( stderr, "fuzz: input written to %s\n", crash_name );
+	}
+	signal( sig, SIG_DFL );
+	raise( sig );
+}
+
+static uint64_t rng;
+
+static uint64_t random64( void )
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 7;
+	rng ^= rng << 17;
+	return rng;
+}
+
+static int run_file( const char *name )
+{
+	FILE *f = fopen( name, "rb" );
+	long len;
+
+	if ( !f ) {
+		fprintf( stderr, "fuzz: can't open %s\n", name );
+		return 1;
+	}
+	fseek( f, 0, SEEK_END );
+	len = ftell( f );
+	fseek( f, 0, SEEK_SET );
+	input = malloc( len ? len : 1 );
+	input_len = fread( input, 1, len, f );
+	fclose( f );
+
+	snprintf( crash_name, sizeof( crash_name ), "crash-%s", strrchr( name, '/' ) ? strrchr( name, '/' ) + 1 : name );
+	LLVMFuzzerTestOneInput( input, input_len );
+	free( input );
+	printf( "fuzz: %s ok\n", name );
+	return 0;
+}
+
+int main( int argc, char *argv[] )
+{
+	long runs = 100000, max_len = 256, i;
+	unsigned long seed = time( NULL );
+	int files = 0, a;
+	size_t j;
+
+	signal( SIGABRT, crashed );
+	signal( SIGSEGV, crashed );
+	signal( SIGILL, crashed );
+
+	for ( a = 1; a < argc; a++ ) {
+		if ( !strncmp( argv[a], "-runs=", 6 ) ) runs = atol( argv[a] + 6 );
+		else if ( !strncmp( argv[a], "-seed=", 6 ) ) seed = strtoul( argv[a] + 6, NULL, 0 );
+		else if ( !strncmp( argv[a], "-max_len=", 9 ) ) max_len = atol( argv[a] + 9 );
+		else if ( argv[a][0] == '-' ) fprintf( stderr, "fuzz: %s ignored\n", argv[a] );
+		else {
+			if ( run_file( argv[a] ) ) return 1;
+			files++;
+		}
+	}
+	if ( files ) return 0;
+
+	input = malloc( max_len ? max_len : 1 );
+	rng = seed * 0x9E3779B97F4A7C15ULL + 1;
+	for ( i = 0; i < runs; i++ ) {
+		input_len = random64() % ( max_len + 1 );
+		for ( j = 0; j < input_len; j++ ) input[j] = random64() >> 24;
+		snprintf( crash_name, sizeof( crash_name ), "crash-%lu-%ld", seed, i );
+		LLVMFuzzerTestOneInput( input, input_len );
+	}
+	free( input );
+	printf( "fuzz: %ld runs ok (seed %lu)\n", runs, seed );
+	return 0;
+}
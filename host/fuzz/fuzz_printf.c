@@ -0,0 +1,183 @@
+/*
+ * Title:			fuzz_printf - compares the library's snprintf with the host C library's
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+// libFuzzer harness (or fuzz_main.c): each input is turned into up to 8 conversions with random
+// flags, width, precision (either may be '*'), length modifier, argument and buffer size, and
+// each snprintf result must match the host's, including the return value when the output is cut
+// short. Bytes past the buffer size must not be touched.
+//
+// Only conversions whose output C defines are made - e.g. no '0' flag with %s, no precision with
+// %c. The float conversions aren't compared, as double is 32 bits on the Agon.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "host_io.h"
+
+#define BUF_MAX			64
+#define GUARD			16
+#define SPECS			8
+
+enum { ARG_INT, ARG_LONG, ARG_LLONG, ARG_STR, ARG_NONE };
+
+static const uint8_t *in;
+static size_t in_len;
+
+static uint8_t next( void )
+{
+	if ( !in_len ) return 0;
+	in_len--;
+	return *in++;
+}
+
+static uint32_t next32( void )
+{
+	uint32_t v = next();
+
+	v |= (uint32_t)next() << 8;
+	v |= (uint32_t)next() << 16;
+	return v | (uint32_t)next() << 24;
+}
+
+static char out[BUF_MAX + GUARD], ref[BUF_MAX + GUARD];
+static char msg[512];
+
+static void compare( const char *fmt, size_t size, int n, int n_ref )
+{
+	size_t len = n_ref < 0 ? 0 : (size_t)n_ref;
+	size_t i;
+
+	if ( size && len > size - 1 ) len = size - 1;
+	if ( n == n_ref && ( !size || ( !memcmp( out, ref, len ) && !out[len] ) ) ) {
+		for ( i = size; i < size + GUARD && (uint8_t)out[i] == 0xA5; i++ );
+		if ( i == size + GUARD ) return;
+		hio_snprintf( msg, sizeof( msg ), "snprintf \"%s\" size %d: wrote past the end of the buffer", fmt, (int)size );
+		hio_fail( msg );
+	}
+	ref[len] = 0;
+	out[len] = 0;
+	hio_snprintf( msg, sizeof( msg ), "snprintf \"%s\" size %d: gave \"%s\" (%d), expected \"%s\" (%d)",
+				  fmt, (int)size, out, n, ref, n_ref );
+	hio_fail( msg );
+}
+
+#define BOTH( ... )		( n = snprintf( out, size, __VA_ARGS__ ), n_ref = hio_snprintf( ref, size, __VA_ARGS__ ) )
+#define CALL( ... )		do { \
+	if ( star_w && star_p ) BOTH( fmt, w, p, __VA_ARGS__ ); \
+	else if ( star_w ) BOTH( fmt, w, __VA_ARGS__ ); \
+	else if ( star_p ) BOTH( fmt, p, __VA_ARGS__ ); \
+	else BOTH( fmt, __VA_ARGS__ ); } while ( 0 )
+
+static void one_spec( void )
+{
+	static const char convs[] = "diuxXocs%";
+	static const char text[] = "ab -:|";
+	char fmt[40];
+	char str[16];
+	char conv = convs[next() % ( sizeof( convs ) - 1 )];
+	bool is_int = strchr( "diuxXo", conv ) != NULL;
+	bool star_w = false, star_p = false;
+	size_t size = next() % ( BUF_MAX + 1 );
+	int kind, w = 0, p = 0, n, n_ref;
+	uint8_t b;
+	size_t f = 0, i;
+
+	for ( i = next() % 4; i; i-- ) fmt[f++] = text[next() % ( sizeof( text ) - 1 )];
+	fmt[f++] = '%';
+
+	if ( conv != '%' ) {
+		// Flags - '+' and ' ' are for signed conversions, '#' for o x X, '0' for the integers
+
+		b = next();
+		if ( b & 1 ) fmt[f++] = '-';
+		if ( ( b & 2 ) && ( conv == 'd' || conv == 'i' ) ) fmt[f++] = '+';
+		if ( ( b & 4 ) && ( conv == 'd' || conv == 'i' ) ) fmt[f++] = ' ';
+		if ( ( b & 8 ) && strchr( "oxX", conv ) ) fmt[f++] = '#';
+		if ( ( b & 16 ) && is_int ) fmt[f++] = '0';
+
+		// Width and precision
+
+		b = next();
+		if ( b & 1 ) {
+			if ( b & 2 ) {
+				star_w = true;
+				w = (int8_t)next() % 24;
+				fmt[f++] = '*';
+			}
+			else f += hio_snprintf( fmt + f, sizeof( fmt ) - f, "%d", next() % 24 );
+		}
+		if ( ( b & 4 ) && conv != 'c' ) {
+			fmt[f++] = '.';
+			if ( b & 8 ) {
+				star_p = true;
+				p = (int8_t)next() % 16;
+				fmt[f++] = '*';
+			}
+			else if ( b & 16 ) f += hio_snprintf( fmt + f, sizeof( fmt ) - f, "%d", next() % 16 );
+		}
+
+		// Length modifier
+
+		kind = is_int ? ARG_INT : conv == 's' ? ARG_STR : ARG_INT;
+		if ( is_int ) {
+			switch ( next() % 6 ) {
+			case 1: fmt[f++] = 'l'; kind = ARG_LONG; break;
+			case 2: fmt[f++] = 'l'; fmt[f++] = 'l'; kind = ARG_LLONG; break;
+			case 3: fmt[f++] = 'h'; break;
+			case 4: fmt[f++] = 'h'; fmt[f++] = 'h'; break;
+			}
+		}
+	}
+	else kind = ARG_NONE;
+	fmt[f++] = conv;
+	for ( i = next() % 3; i; i-- ) fmt[f++] = text[next() % ( sizeof( text ) - 1 )];
+	fmt[f] = 0;
+
+	memset( out, 0xA5, sizeof( out ) );
+	memset( ref, 0xA5, sizeof( ref ) );
+
+	switch ( kind ) {
+	case ARG_INT: {
+		int v = conv == 'c' ? next() % 255 + 1 : (int)next32();
+
+		CALL( v );
+		break;
+	}
+	case ARG_LONG: {
+		long v = (long)( (uint64_t)next32() << 32 | next32() );
+
+		CALL( v );
+		break;
+	}
+	case ARG_LLONG: {
+		long long v = (long long)( (uint64_t)next32() << 32 | next32() );
+
+		CALL( v );
+		break;
+	}
+	case ARG_STR:
+		for ( i = 0, b = next() % sizeof( str ); i < b; i++ ) str[i] = next() % 95 + 32;
+		str[i] = 0;
+		CALL( str );
+		break;
+	default:
+		CALL( 0 );
+	}
+	compare( fmt, size, n, n_ref );
+}
+
+int LLVMFuzzerTestOneInput( const uint8_t *data, size_t size )
+{
+	int i;
+
+	in = data;
+	in_len = size;
+	for ( i = 0; i < SPECS && in_len; i++ ) one_spec();
+	return 0;
+}
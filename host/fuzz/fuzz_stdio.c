@@ -0,0 +1,173 @@
+/*
+ * Title:			fuzz_stdio - checks the file functions against a model of the file in memory
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+// libFuzzer harness (or fuzz_main.c): each input is a sequence of operations on a file opened
+// "w+b" - fputc, fwrite, fgetc, fread, fgets, fseek (SET, CUR and END, within the file), ftell,
+// fflush and closing and reopening "r+b". The return values, the data read and the position
+// after each one must match the model.
+//
+// Data bytes are 1 - 127 - fgetc can't tell a NUL byte from the end of the file (mos_fgetc
+// returns 0 for both), and a byte over 127 is returned as a negative char, so 255 reads as EOF.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "host_io.h"
+
+#define FUZZ_FILE		"fuzz_stdio.tmp"
+#define FILE_MAX		512
+#define CHUNK_MAX		32
+
+int remove( const char *filename );		// remove.c - not declared in stdio.h
+
+static const uint8_t *in;
+static size_t in_len;
+
+static uint8_t next( void )
+{
+	if ( !in_len ) return 0;
+	in_len--;
+	return *in++;
+}
+
+static uint8_t model[FILE_MAX];
+static long size, pos;
+static char msg[256];
+static int op_count;
+
+static void check( bool ok, const char *op, long got, long expected )
+{
+	if ( ok ) return;
+	hio_snprintf( msg, sizeof( msg ), "stdio op %d (%s): got %ld, expected %ld (position %ld, size %ld)",
+				  op_count, op, got, expected, pos, size );
+	remove( FUZZ_FILE );
+	hio_fail( msg );
+}
+
+static void wrote( const uint8_t *data, long n )
+{
+	memcpy( model + pos, data, n );
+	pos += n;
+	if ( pos > size ) size = pos;
+}
+
+int LLVMFuzzerTestOneInput( const uint8_t *data, size_t len )
+{
+	FILE *f = fopen( FUZZ_FILE, "w+b" );
+	uint8_t buf[CHUNK_MAX + 1];
+	long n, i, expect;
+	int c;
+
+	check( f != NULL, "fopen", 0, 1 );
+	in = data;
+	in_len = len;
+	size = pos = 0;
+	op_count = 0;
+
+	while ( in_len ) {
+		uint8_t op = next();
+
+		op_count++;
+		n = next() % ( CHUNK_MAX + 1 );
+		switch ( op % 11 ) {
+		case 0:							// fputc
+			if ( pos == FILE_MAX ) break;
+			buf[0] = n % 127 + 1;
+			c = fputc( buf[0], f );
+			check( c == buf[0], "fputc", c, buf[0] );
+			wrote( buf, 1 );
+			break;
+		case 1:							// fwrite
+			if ( n > FILE_MAX - pos ) n = FILE_MAX - pos;
+			for ( i = 0; i < n; i++ ) buf[i] = next() % 127 + 1;
+			i = fwrite( buf, 1, n, f );
+			check( i == n, "fwrite", i, n );
+			wrote( buf, n );
+			break;
+		case 2:							// fgetc
+			c = fgetc( f );
+			expect = pos < size ? model[pos++] : EOF;
+			check( c == expect, "fgetc", c, expect );
+			break;
+		case 3:							// fread
+			expect = n < size - pos ? n : size - pos;
+			i = fread( buf, 1, n, f );
+			check( i == expect, "fread", i, expect );
+			check( !memcmp( buf, model + pos, i ), "fread data", 0, 0 );
+			pos += i;
+			break;
+		case 4: {						// fgets, reading up to n - 1 bytes or to a '\n'
+			char *s;
+
+			if ( !n ) break;
+			memset( buf, 0xA5, sizeof( buf ) );
+			s = fgets( (char *)buf, n, f );
+			for ( expect = 0; expect < n - 1 && pos + expect < size; ) {
+				if ( model[pos + expect++] == '\n' ) break;
+			}
+			if ( n > 1 && !expect ) {
+				check( s == NULL, "fgets at the end", 1, 0 );
+				break;
+			}
+			check( s == (char *)buf, "fgets", 0, 1 );
+			i = strlen( s );
+			check( i == expect, "fgets length", i, expect );
+			check( !memcmp( buf, model + pos, i ), "fgets data", 0, 0 );
+			pos += i;
+			break;
+		}
+		case 5:							// fseek SEEK_SET
+			expect = size ? next() % ( size + 1 ) : 0;
+			c = fseek( f, expect, SEEK_SET );
+			check( c == 0, "fseek SEEK_SET", c, 0 );
+			pos = expect;
+			break;
+		case 6:							// fseek SEEK_CUR, back or forward within the file
+			expect = size ? next() % ( size + 1 ) : 0;
+			c = fseek( f, expect - pos, SEEK_CUR );
+			check( c == 0, "fseek SEEK_CUR", c, 0 );
+			pos = expect;
+			break;
+		case 7:							// fseek SEEK_END
+			expect = size ? next() % ( size + 1 ) : 0;
+			c = fseek( f, -( size - expect ), SEEK_END );
+			check( c == 0, "fseek SEEK_END", c, 0 );
+			pos = expect;
+			break;
+		case 8:
+			i = ftell( f );
+			check( i == pos, "ftell", i, pos );
+			break;
+		case 9:
+			c = fflush( f );
+			check( c == 0, "fflush", c, 0 );
+			break;
+		case 10:						// close and reopen, keeping the contents
+			fclose( f );
+			f = fopen( FUZZ_FILE, "r+b" );
+			check( f != NULL, "fopen r+b", 0, 1 );
+			pos = 0;
+			break;
+		}
+	}
+
+	// The file must hold what the model does
+
+	fclose( f );
+	f = fopen( FUZZ_FILE, "rb" );
+	for ( i = 0; i < size; i++ ) {
+		c = fgetc( f );
+		check( c == model[i], "contents", c, model[i] );
+	}
+	c = fgetc( f );
+	check( c == EOF, "contents end", c, EOF );
+	fclose( f );
+	remove( FUZZ_FILE );
+	return 0;
+}
@@ -0,0 +1,178 @@
+// Host side of the MOS / VDP shim - see host_io.h
+//
+// Built with the host's headers, so it can't include anything from src/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "host_io.h"
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// FatFs modes (mos_api.h)
+
+#define FA_READ				0x01
+#define FA_WRITE			0x02
+#define FA_CREATE_NEW		0x04
+#define FA_CREATE_ALWAYS	0x08
+#define FA_OPEN_ALWAYS		0x10
+#define FA_OPEN_APPEND		0x30
+
+#define HIO_FILES			16
+
+// The host stdio buffers the files, so the shim's byte at a time mos_fgetc / mos_fputc are cheap
+// - a seek is needed between a read and a write on the same FILE
+
+static struct {
+	FILE *f;
+	int writing;
+} files[HIO_FILES];
+
+int hio_open( const char *path, int mode )
+{
+	int flags, fd, i;
+	FILE *f;
+
+	for ( i = 0; i < HIO_FILES && files[i].f; i++ );
+	if ( i == HIO_FILES ) return -1;
+
+	if ( ( mode & ( FA_READ | FA_WRITE ) ) == ( FA_READ | FA_WRITE ) ) flags = O_RDWR;
+	else if ( mode & FA_WRITE ) flags = O_WRONLY;
+	else flags = O_RDONLY;
+
+	if ( ( mode & FA_OPEN_APPEND ) == FA_OPEN_APPEND || ( mode & FA_OPEN_ALWAYS ) ) flags |= O_CREAT;
+	else if ( mode & FA_CREATE_ALWAYS ) flags |= O_CREAT | O_TRUNC;
+	else if ( mode & FA_CREATE_NEW ) flags |= O_CREAT | O_EXCL;
+
+	fd = open( path, flags, 0644 );
+	if ( fd < 0 ) return -1;
+	f = fdopen( fd, flags & O_RDWR ? "r+b" : flags & O_WRONLY ? "wb" : "rb" );
+	if ( !f ) {
+		close( fd );
+		return -1;
+	}
+	if ( ( mode & FA_OPEN_APPEND ) == FA_OPEN_APPEND ) fseek( f, 0, SEEK_END );
+
+	files[i].f = f;
+	files[i].writing = 0;
+	return i;
+}
+
+void hio_close( int fd )
+{
+	if ( fd < 0 || fd >= HIO_FILES || !files[fd].f ) return;
+	fclose( files[fd].f );
+	files[fd].f = NULL;
+}
+
+// writing is 1 / 0 before a write / read, or -1 for neither
+
+static FILE *file_for( int fd, int writing )
+{
+	if ( fd < 0 || fd >= HIO_FILES || !files[fd].f ) return NULL;
+	if ( writing >= 0 && files[fd].writing != writing ) {
+		fseek( files[fd].f, 0, SEEK_CUR );
+		files[fd].writing = writing;
+	}
+	return files[fd].f;
+}
+
+long hio_read( int fd, void *buf, long len )
+{
+	FILE *f = file_for( fd, 0 );
+
+	return f ? (long)fread( buf, 1, len, f ) : 0;
+}
+
+long hio_write( int fd, const void *buf, long len )
+{
+	FILE *f = file_for( fd, 1 );
+
+	return f ? (long)fwrite( buf, 1, len, f ) : 0;
+}
+
+long hio_seek( int fd, long offset )
+{
+	FILE *f = file_for( fd, -1 );
+
+	if ( !f || fseek( f, offset, SEEK_SET ) ) return -1;
+	return ftell( f );
+}
+
+long hio_size( int fd )
+{
+	struct stat st;
+	FILE *f = file_for( fd, -1 );
+
+	if ( !f ) return 0;
+	if ( files[fd].writing ) fflush( f );
+	return fstat( fileno( f ), &st ) ? 0 : (long)st.st_size;
+}
+
+int hio_unlink( const char *path )
+{
+	return unlink( path );
+}
+
+void hio_print( const void *buf, long len )
+{
+	fwrite( buf, 1, len, stdout );
+}
+
+int hio_read_line( char *buf, int size )
+{
+	size_t len;
+
+	fflush( stdout );
+	if ( !fgets( buf, size, stdin ) ) return -1;
+	len = strcspn( buf, "\r\n" );
+	buf[len] = 0;
+	return (int)len;
+}
+
+unsigned long long hio_ns( void )
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void hio_local_rtc( int *fields )
+{
+	time_t now = time( NULL );
+	struct tm tm;
+
+	localtime_r( &now, &tm );
+	fields[0] = tm.tm_year - 80;
+	fields[1] = tm.tm_mon;
+	fields[2] = tm.tm_mday;
+	fields[3] = tm.tm_yday;
+	fields[4] = tm.tm_wday;
+	fields[5] = tm.tm_hour;
+	fields[6] = tm.tm_min;
+	fields[7] = tm.tm_sec;
+}
+
+int hio_snprintf( char *buf, unsigned long size, const char *fmt, ... )
+{
+	va_list ap;
+	int n;
+
+	va_start( ap, fmt );
+	n = vsnprintf( buf, size, fmt, ap );
+	va_end( ap );
+	return n;
+}
+
+void hio_fail( const char *msg )
+{
+	fflush( stdout );
+	fprintf( stderr, "%s\n", msg );
+	abort();
+}
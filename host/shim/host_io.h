@@ -0,0 +1,47 @@
+#ifndef _HOST_IO_H
+#define _HOST_IO_H
+
+// Host side of the MOS / VDP shim
+//
+// - host_io.c is the only file built against the host's own headers, everything else in host/ is
+//   built against the toolchain headers (src/libc/include), as it would be for the Agon
+// - so only plain C types are used here, which are the same size on both sides
+// - the names aren't renamed by the makefile (see agdev.syms), so the repo side can call them
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Files - mode is the FatFs FA_* mode passed to mos_fopen, returns -1 if it can't be opened
+
+int hio_open( const char *path, int mode );
+void hio_close( int fd );
+long hio_read( int fd, void *buf, long len );
+long hio_write( int fd, const void *buf, long len );
+long hio_seek( int fd, long offset );				// from the start, returns the new position or -1
+long hio_size( int fd );
+int hio_unlink( const char *path );					// 0 if deleted
+
+// Console - text for the terminal, and a line of input (without the newline), -1 at the end
+
+void hio_print( const void *buf, long len );
+int hio_read_line( char *buf, int size );
+
+// Clocks
+
+unsigned long long hio_ns( void );					// monotonic, nanoseconds
+// Local time as the sysvar RTC holds it: year - 1980, month (0-11), day, day of year,
+// day of week, hour, minute, second
+void hio_local_rtc( int *fields );
+
+// The host C library's snprintf, for comparing the repo's against
+int hio_snprintf( char *buf, unsigned long size, const char *fmt, ... );
+
+// Stop with a message, e.g. when a fuzz harness finds a difference
+void hio_fail( const char *msg );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
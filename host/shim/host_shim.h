@@ -0,0 +1,65 @@
+#ifndef _HOST_SHIM_H
+#define _HOST_SHIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MOS / VDP simulation for the host build (host/makefile)
+//
+// mos_shim.c provides the MOS calls used by the C parts of src/libc and src/agon, built for the
+// host against the toolchain headers:
+// - files are host files (paths as given, relative to the current directory), with the FIL
+//   fptr / objsize that fseek and ftell read kept up to date
+// - everything sent to the VDP (putch, outchar, mos_puts) is split into VDU commands and counted,
+//   and can be recorded. Text outside commands is echoed to the terminal
+// - the VDP's replies are simulated for mode changes and the mode / cursor requests, which set
+//   the sysvars and vpd_pflags straight away
+// - the sysvar clock runs from the host clock, or only moves when told to
+// - keys are injected into vdp_key_bits as the UART0 handler would set them - vdp_key_init()
+//   returns -1, as there is no MOS handler to fingerprint
+//
+// Calls not listed in mos_shim.c (mos_load, the UART and I2C calls ...) aren't simulated, so a
+// host build using them fails to link.
+
+typedef struct {
+	uint32_t mos_calls;			// every simulated MOS call, including putch and outchar
+	uint32_t vdu_calls;			// putch, outchar and mos_puts
+	uint32_t vdu_bytes;
+	uint32_t vdu_commands;
+	uint32_t file_calls;		// mos_fopen ... mos_getfil
+} HOST_STATS;
+
+extern HOST_STATS host_stats;
+
+void host_reset_stats( void );
+
+// Record the VDU stream in buf (NULL to stop) - host_vdu_recorded() is the length kept so far
+void host_vdu_record( uint8_t *buf, uint24_t size );
+uint24_t host_vdu_recorded( void );
+
+// Echo text sent to the VDP to the terminal (on by default)
+void host_vdu_echo( bool on );
+
+// Manual clock: the sysvar time only changes with host_clock_advance() (and waitvblank)
+void host_clock_manual( bool on );
+void host_clock_advance( uint32_t cs );
+
+// Date and time returned by mos_getrtc, or NULL for the host's local time
+void host_rtc_set( const RTC_DATA *rtc );
+
+// Key down / up as reported by the VDP (KB_KEY_* codes)
+void host_key( uint8_t code, bool down );
+
+// Console input for mos_editline, one line per '\n' - the host's stdin is read after it
+void host_input( const char *text );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,566 @@
+// MOS / VDP simulation for the host build - see host_shim.h
+//
+// Built against the toolchain headers like the library code it links with, and calls the host
+// through host_io.h. It also provides the routines that are assembler on the Agon (putchar,
+// outchar, ungetc, __isleap) and the symbols from crt0 and intagon.src used by the C code.
+
+#include "host_shim.h"
+#include "host_io.h"
+#include <stdio.h>
+#include <string.h>
+#include <vdp_key.h>
+
+#define SHIM_FILES			8				// as MOS
+#define SHIM_HDR_MAX		16
+#define SHIM_INPUT_MAX		1024
+
+HOST_STATS host_stats;
+
+// crt0 / intagon.src
+
+static SYSVAR sysvars = { .scrWidth = 640, .scrHeight = 480, .scrCols = 80, .scrRows = 60, .scrColours = 16 };
+
+volatile SYSVAR *_agdev_sysvars = &sysvars;
+
+uint24_t _agdev_UART0_serial_RX;
+uint24_t _agdev_vdp_protocol_data;
+uint24_t _agdev_vdp_protocol;
+
+void _agdev_default_mi_handler( void ) {}
+void _agdev_uart0_handler( void ) {}
+
+// Clock
+
+static bool clock_manual = false;
+static unsigned long long clock_start;
+
+static void clock_tick( void )
+{
+	if ( clock_manual ) return;
+	if ( !clock_start ) clock_start = hio_ns();
+	sysvars.time = ( hio_ns() - clock_start ) / 10000000ULL;
+}
+
+void host_clock_manual( bool on )
+{
+	clock_tick();
+	clock_manual = on;
+}
+
+void host_clock_advance( uint32_t cs )
+{
+	sysvars.time += cs;
+}
+
+static void mos_call( void )
+{
+	host_stats.mos_calls++;
+	clock_tick();
+}
+
+void host_reset_stats( void )
+{
+	memset( &host_stats, 0, sizeof( host_stats ) );
+}
+
+// VDP
+//
+// - the commands are split up as vdp_capture.c does, with the bytes after a command at the start
+//   of a write (putch / outchar are a write of one byte), and text in between
+// - mode changes and the requests that the library waits for are answered in the sysvars
+
+static const struct { uint16_t w, h; uint8_t colours; } modes[] = {
+	{ 640, 480, 16 }, { 640, 480, 4 }, { 640, 480, 2 }, { 640, 240, 64 },
+	{ 640, 240, 16 }, { 640, 240, 4 }, { 640, 240, 2 }, { 640, 480, 64 },
+	{ 320, 240, 64 }, { 320, 240, 16 }, { 320, 240, 4 }, { 320, 240, 2 },
+	{ 320, 200, 64 }, { 320, 200, 16 }, { 320, 200, 4 }, { 320, 200, 2 },
+	{ 800, 600, 4 }, { 800, 600, 2 }, { 1024, 768, 2 }
+};
+
+// Length of VDU 0 - 31 including the code (23 depends on the next bytes)
+
+static const uint8_t vdu_len[32] = {
+	1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 2, 3, 6, 1, 1, 2, 0, 9, 6, 1, 2, 5, 5, 1, 3
+};
+
+// Length of VDU 23, 27, n for n = 0 .. 16
+
+static const uint8_t vdu_27_len[17] = { 4, 7, 11, 7, 4, 3, 4, 4, 3, 3, 4, 3, 3, 7, 7, 3, 3 };
+
+static uint8_t hdr[SHIM_HDR_MAX];
+static uint8_t hdr_len;
+static uint32_t data_left;				// bytes of data following the last command
+
+static uint8_t *record_buf = NULL;
+static uint24_t record_size;
+static uint24_t record_len;
+static bool echo = true;
+
+void host_vdu_record( uint8_t *buf, uint24_t size )
+{
+	record_buf = buf;
+	record_size = buf ? size : 0;
+	record_len = 0;
+}
+
+uint24_t host_vdu_recorded( void )
+{
+	return record_len;
+}
+
+void host_vdu_echo( bool on )
+{
+	echo = on;
+}
+
+// Total length of the command in hdr, 0 if it runs to the end of the write, or -1 if more bytes
+// are needed to tell
+
+static int cmd_len( void )
+{
+	uint8_t c = hdr[0];
+
+	if ( c != 23 ) return vdu_len[c];
+	if ( hdr_len < 2 ) return -1;
+	if ( hdr[1] >= 32 ) return 10;
+	if ( hdr[1] == 1 ) return 3;
+	if ( hdr[1] != 0 && hdr[1] != 27 ) return 0;
+	if ( hdr_len < 3 ) return -1;
+
+	if ( hdr[1] == 27 ) {
+		c = hdr[2];
+		if ( c <= 16 ) return vdu_27_len[c];
+		if ( c == 0x20 || c == 0x26 ) return 5;
+		if ( c == 0x21 ) return 8;
+		return 0;
+	}
+
+	switch ( hdr[2] ) {
+	case 0xA0:
+		if ( hdr_len < 6 ) return -1;
+		switch ( hdr[5] ) {
+		case 0: case 3: case 15:	return 8;
+		case 2: case 4: case 14:	return 6;
+		case 17:					return 10;
+		case 20:					return 12;
+		default:					return 0;
+		}
+	case 0x82: case 0x86: case 0xC3: case 0xCA: case 0xFF:
+		return 3;
+	case 0x80: case 0x81: case 0x94: case 0xC0: case 0xC1: case 0xFE:
+		return 4;
+	case 0x83: case 0x84:
+		return 7;
+	default:
+		return 0;
+	}
+}
+
+static void set_mode( uint8_t mode )
+{
+	uint8_t m = mode & 0x7F;				// 128+ are the double buffered versions
+
+	if ( m >= sizeof( modes ) / sizeof( modes[0] ) ) m = 0;
+	sysvars.scrMode = mode;
+	sysvars.scrWidth = modes[m].w;
+	sysvars.scrHeight = modes[m].h;
+	sysvars.scrCols = modes[m].w / 8;
+	sysvars.scrRows = modes[m].h / 8;
+	sysvars.scrColours = modes[m].colours;
+	sysvars.cursorX = sysvars.cursorY = 0;
+}
+
+static void cmd_end( void )
+{
+	host_stats.vdu_commands++;
+
+	if ( hdr[0] == 22 && hdr_len == 2 ) set_mode( hdr[1] );
+	else if ( hdr[0] == 12 || hdr[0] == 30 ) sysvars.cursorX = sysvars.cursorY = 0;
+	else if ( hdr[0] == 31 && hdr_len == 3 ) {
+		sysvars.cursorX = hdr[1];
+		sysvars.cursorY = hdr[2];
+	}
+	else if ( hdr[0] == 23 && hdr_len >= 3 && hdr[1] == 0 ) {
+		if ( hdr[2] == 0x86 ) sysvars.vpd_pflags |= vdp_pflag_mode;
+		else if ( hdr[2] == 0x82 ) sysvars.vpd_pflags |= vdp_pflag_cursor;
+	}
+
+	data_left = 0;
+	if ( hdr_len == 7 && hdr[0] == 23 && hdr[1] == 27 && hdr[2] == 1 )
+		data_left = (uint32_t)( hdr[3] | hdr[4] << 8 ) * ( hdr[5] | hdr[6] << 8 ) * 4;
+	else if ( hdr_len == 8 && hdr[0] == 23 && hdr[1] == 0 && hdr[2] == 0xA0 && hdr[5] == 0 )
+		data_left = hdr[6] | hdr[7] << 8;
+	hdr_len = 0;
+}
+
+static void text( uint8_t c )
+{
+	if ( c == '\r' ) return;
+	if ( c == '\n' ) sysvars.cursorY++;
+	else sysvars.cursorX++;
+	if ( echo ) hio_print( &c, 1 );
+}
+
+static void vdu_write( const uint8_t *p, uint24_t len, bool write_end )
+{
+	int n;
+
+	host_stats.vdu_calls++;
+	host_stats.vdu_bytes += len;
+	if ( record_len < record_size ) {
+		n = record_size - record_len < len ? record_size - record_len : len;
+		memcpy( record_buf + record_len, p, n );
+		record_len += n;
+	}
+
+	while ( len-- ) {
+		uint8_t c = *p++;
+
+		if ( data_left ) {
+			data_left--;
+			continue;
+		}
+		if ( !hdr_len && ( c >= 32 || c == '\r' || c == '\n' ) ) {
+			if ( c != 127 ) text( c );
+			continue;
+		}
+		hdr[hdr_len++] = c;
+		n = cmd_len();
+		if ( ( n > 0 && hdr_len >= n ) || ( n == 0 && hdr_len == SHIM_HDR_MAX ) ) cmd_end();
+	}
+	if ( write_end && hdr_len && cmd_len() == 0 ) cmd_end();
+}
+
+int putch( int a )
+{
+	uint8_t c = a;
+
+	mos_call();
+	vdu_write( &c, 1, false );
+	return a;
+}
+
+void outchar( char character )
+{
+	mos_call();
+	vdu_write( (uint8_t *)&character, 1, false );
+}
+
+void mos_puts( char *buffer, uint24_t size, char delimiter )
+{
+	mos_call();
+	if ( !size ) size = strchr( buffer, delimiter ) - buffer;
+	vdu_write( (uint8_t *)buffer, size, true );
+}
+
+// putchar.src
+
+int putchar( int character )
+{
+	if ( stdout->fhandle != FH_STDOUT ) return fputc( character, stdout );
+	if ( character == '\n' ) outchar( '\r' );
+	outchar( character );
+	return character;
+}
+
+void waitvblank( void )
+{
+	uint32_t t = sysvars.time;
+
+	if ( clock_manual ) host_clock_advance( 2 );
+	else while ( sysvars.time - t < 2 ) clock_tick();
+}
+
+// Console input
+
+static char input[SHIM_INPUT_MAX];
+static uint24_t input_pos;
+static uint24_t input_len;
+
+void host_input( const char *text )
+{
+	uint24_t len = strlen( text );
+
+	if ( len > SHIM_INPUT_MAX - input_len + input_pos ) len = SHIM_INPUT_MAX - input_len + input_pos;
+	memmove( input, input + input_pos, input_len - input_pos );
+	input_len -= input_pos;
+	input_pos = 0;
+	memcpy( input + input_len, text, len );
+	input_len += len;
+}
+
+// Returns 13 (Enter), or 27 (Escape) at the end of the input
+
+uint8_t mos_editline( char *buffer, uint24_t bufferlength, uint8_t clearbuffer )
+{
+	uint24_t n = 0;
+
+	(void)clearbuffer;
+	mos_call();
+	if ( input_pos < input_len ) {
+		while ( input_pos < input_len && input[input_pos] != '\n' ) {
+			if ( n < bufferlength - 1 ) buffer[n++] = input[input_pos];
+			input_pos++;
+		}
+		if ( input_pos < input_len ) input_pos++;
+		buffer[n] = 0;
+	}
+	else if ( hio_read_line( buffer, bufferlength ) < 0 ) {
+		buffer[0] = 0;
+		return 27;
+	}
+	for ( n = 0; buffer[n]; n++ ) text( buffer[n] );		// MOS shows the line as it's typed
+	return 13;
+}
+
+char getch( void )
+{
+	char c = 0;
+
+	mos_call();
+	if ( input_pos < input_len ) c = input[input_pos++];
+	if ( c == '\n' ) c = '\r';
+	sysvars.keyascii = c;
+	return c;
+}
+
+// Files
+//
+// - handles are 1 - SHIM_FILES as MOS
+// - seeking past the end of a file open for writing extends it, as FatFs does
+
+static struct {
+	int fd;								// host file, -1 if not open
+	uint8_t mode;
+	FIL fil;
+} files[SHIM_FILES + 1];
+
+static bool files_init = false;
+
+static FIL *file( uint8_t fh )
+{
+	if ( fh < 1 || fh > SHIM_FILES || !files_init || files[fh].fd < 0 ) return NULL;
+	return &files[fh].fil;
+}
+
+static void moved( uint8_t fh, uint24_t n )
+{
+	FIL *fil = &files[fh].fil;
+
+	fil->fptr += n;
+	if ( fil->fptr > fil->obj.objsize ) fil->obj.objsize = fil->fptr;
+}
+
+uint8_t mos_fopen( const char *filename, uint8_t mode )
+{
+	uint8_t fh;
+	int fd;
+
+	mos_call();
+	host_stats.file_calls++;
+	if ( !files_init ) {
+		for ( fh = 0; fh <= SHIM_FILES; fh++ ) files[fh].fd = -1;
+		files_init = true;
+	}
+	for ( fh = 1; fh <= SHIM_FILES && files[fh].fd >= 0; fh++ );
+	if ( fh > SHIM_FILES ) return 0;
+
+	fd = hio_open( filename, mode );
+	if ( fd < 0 ) return 0;
+
+	files[fh].fd = fd;
+	files[fh].mode = mode;
+	memset( &files[fh].fil, 0, sizeof( FIL ) );
+	files[fh].fil.obj.objsize = hio_size( fd );
+	if ( ( mode & FA_OPEN_APPEND ) == FA_OPEN_APPEND ) files[fh].fil.fptr = files[fh].fil.obj.objsize;
+	return fh;
+}
+
+uint8_t mos_fclose( uint8_t fh )
+{
+	uint8_t open = 0;
+	uint8_t i;
+
+	mos_call();
+	host_stats.file_calls++;
+	if ( file( fh ) ) {
+		hio_close( files[fh].fd );
+		files[fh].fd = -1;
+	}
+	for ( i = 1; i <= SHIM_FILES; i++ ) if ( file( i ) ) open++;
+	return open;
+}
+
+char mos_fgetc( uint8_t fh )
+{
+	char c;
+
+	mos_call();
+	host_stats.file_calls++;
+	if ( !file( fh ) || hio_read( files[fh].fd, &c, 1 ) != 1 ) return 0;
+	moved( fh, 1 );
+	return c;
+}
+
+void mos_fputc( uint8_t fh, char c )
+{
+	mos_call();
+	host_stats.file_calls++;
+	if ( file( fh ) && hio_write( files[fh].fd, &c, 1 ) == 1 ) moved( fh, 1 );
+}
+
+uint8_t mos_feof( uint8_t fh )
+{
+	FIL *fil = file( fh );
+
+	mos_call();
+	host_stats.file_calls++;
+	return !fil || fil->fptr >= fil->obj.objsize;
+}
+
+uint24_t mos_fread( uint8_t fh, char *buffer, uint24_t numbytes )
+{
+	long n;
+
+	mos_call();
+	host_stats.file_calls++;
+	if ( !file( fh ) ) return 0;
+	n = hio_read( files[fh].fd, buffer, numbytes );
+	moved( fh, n );
+	return n;
+}
+
+uint24_t mos_fwrite( uint8_t fh, char *buffer, uint24_t numbytes )
+{
+	long n;
+
+	mos_call();
+	host_stats.file_calls++;
+	if ( !file( fh ) ) return 0;
+	n = hio_write( files[fh].fd, buffer, numbytes );
+	moved( fh, n );
+	return n;
+}
+
+uint8_t mos_flseek( uint8_t fh, uint32_t offset )
+{
+	FIL *fil = file( fh );
+	static const char zero[64];
+
+	mos_call();
+	host_stats.file_calls++;
+	if ( !fil ) return FR_INVALID_OBJECT;
+
+	if ( offset > fil->obj.objsize ) {
+		if ( !( files[fh].mode & FA_WRITE ) ) offset = fil->obj.objsize;
+		else {
+			hio_seek( files[fh].fd, fil->obj.objsize );
+			while ( fil->obj.objsize < offset ) {
+				uint32_t n = offset - fil->obj.objsize < sizeof( zero ) ? offset - fil->obj.objsize : sizeof( zero );
+
+				if ( hio_write( files[fh].fd, zero, n ) != (long)n ) return FR_DISK_ERR;
+				fil->obj.objsize += n;
+			}
+		}
+	}
+	if ( hio_seek( files[fh].fd, offset ) < 0 ) return FR_DISK_ERR;
+	fil->fptr = offset;
+	return FR_OK;
+}
+
+FIL *mos_getfil( uint8_t fh )
+{
+	mos_call();
+	host_stats.file_calls++;
+	return file( fh );
+}
+
+uint8_t mos_del( const char *filename )
+{
+	mos_call();
+	host_stats.file_calls++;
+	return hio_unlink( filename ) ? FR_NO_FILE : FR_OK;
+}
+
+// System
+
+static bool rtc_fixed = false;
+static RTC_DATA rtc_value;
+
+void host_rtc_set( const RTC_DATA *rtc )
+{
+	rtc_fixed = rtc != NULL;
+	if ( rtc ) rtc_value = *rtc;
+}
+
+uint8_t mos_getrtc( char *buffer )
+{
+	static const char *const days[7] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+	RTC_DATA rtc = rtc_value;
+
+	mos_call();
+	if ( !rtc_fixed ) {
+		int f[8];
+
+		hio_local_rtc( f );
+		rtc.year = f[0];
+		rtc.month = f[1];
+		rtc.day = f[2];
+		rtc.day_of_year = f[3];
+		rtc.day_of_week = f[4];
+		rtc.hour = f[5];
+		rtc.minute = f[6];
+		rtc.second = f[7];
+	}
+	sysvars.rtc = rtc;
+	sysvars.vpd_pflags |= vdp_pflag_rtc;
+	return sprintf( buffer, "%s, %02d/%02d/%04d %02d:%02d:%02d", days[rtc.day_of_week % 7], rtc.day,
+					rtc.month + 1, rtc.year + 1980, rtc.hour, rtc.minute, rtc.second );
+}
+
+uint8_t *mos_sysvars( void )
+{
+	mos_call();
+	return (uint8_t *)&sysvars;
+}
+
+// Interrupt vectors - the UART0 handler is a byte that doesn't match vdp_key_init's fingerprint
+
+static const uint8_t uart0_handler[1];
+static void (*vectors[64])( void );
+
+void *mos_setintvector( uint8_t vector, void (*handler)( void ) )
+{
+	void (*prev)( void );
+
+	mos_call();
+	if ( !vectors[0x18] ) vectors[0x18] = (void (*)( void ))uart0_handler;
+	prev = vectors[vector & 63];
+	vectors[vector & 63] = handler;
+	return prev;
+}
+
+void host_key( uint8_t code, bool down )
+{
+	if ( down ) vdp_key_bits[KB_BYTE( code )] |= KB_BIT( code );
+	else vdp_key_bits[KB_BYTE( code )] &= ~KB_BIT( code );
+	sysvars.vkeycode = code;
+	sysvars.vkeydown = down;
+	sysvars.vkeycount++;
+}
+
+// ungetc (from the toolchain's libc) and isleap.c.src
+
+int ungetc( int c, FILE *stream )
+{
+	if ( c == EOF || !stream ) return EOF;
+	stream->unget_char = c;
+	stream->eof = 0;
+	return c;
+}
+
+bool __isleap( int year )
+{
+	return !( year % 100 ) ? !( year % 400 ) : !( year & 3 );
+}
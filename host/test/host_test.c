@@ -0,0 +1,335 @@
+/*
+ * Title:			host_test - checks the library code in the host build
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+// Built against the toolchain headers and linked with src/libc and src/agon C code and the
+// MOS / VDP shim (see host/readme.md). Output goes through the library's own printf.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <mos_api.h>
+#include <vdp_vdu.h>
+#include <vdp_key.h>
+#include "host_shim.h"
+#include "host_io.h"
+
+#define TEST_FILE		"host_test.tmp"
+
+int remove( const char *filename );		// remove.c - not declared in stdio.h
+
+static int checks, failures;
+
+static void check( bool ok, const char *what, int line )
+{
+	checks++;
+	if ( ok ) return;
+	failures++;
+	printf( "FAIL line %d: %s\n", line, what );
+}
+
+#define CHECK( cond )	check( cond, #cond, __LINE__ )
+
+// printf - the result and the return value must match the host C library's
+
+static char out[256], ref[256];
+
+static void check_fmt( int line, const char *fmt, int n, int n_ref )
+{
+	checks++;
+	if ( n == n_ref && !strcmp( out, ref ) ) return;
+	failures++;
+	printf( "FAIL line %d: \"%s\" gave \"%s\" (%d), expected \"%s\" (%d)\n", line, fmt, out, n, ref, n_ref );
+}
+
+#define CHECK_FMT( fmt, ... )	check_fmt( __LINE__, fmt, snprintf( out, sizeof( out ), fmt, __VA_ARGS__ ), \
+											hio_snprintf( ref, sizeof( ref ), fmt, __VA_ARGS__ ) )
+
+static void test_printf( void )
+{
+	CHECK_FMT( "%d %d %d", 0, -1, 8388607 );
+	CHECK_FMT( "[%5d] [%-5d] [%05d] [%+d] [% d]", 42, 42, -42, 42, 42 );
+	CHECK_FMT( "%u %x %X %#x %o %#o", 4000000000u, 0xBEEFu, 0xBEEFu, 255u, 8u, 8u );
+	CHECK_FMT( "%ld %lu %lx", -123456789L, 3000000000UL, 0xDEADBEEFUL );
+	CHECK_FMT( "[%c] [%3c] [%-3c]", 'a', 'b', 'c' );
+	CHECK_FMT( "[%s] [%8s] [%-8s] [%.3s] [%8.2s]", "abc", "abc", "abc", "abcdef", "abcdef" );
+	CHECK_FMT( "[%*d] [%-*d] [%.*s]", 6, 7, 6, 7, 2, "xyz" );
+	CHECK_FMT( "%.3d %.0d|%5.3d", 7, 0, -7 );
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat"				// the 0 flag is ignored with a precision - on purpose
+	CHECK_FMT( "[%*d] [%05.3d] [%0*x]", -6, 7, 7, -6, 0xABu );
+#pragma GCC diagnostic pop
+	CHECK_FMT( "100%% %s", "done" );
+	CHECK_FMT( "%.2f %.1f %.3f", 0.5, -2.25, 100.0 );
+
+	// Truncation - the return value is the full length
+
+	CHECK( snprintf( out, 5, "%s", "hello world" ) == 11 && !strcmp( out, "hell" ) );
+	CHECK( snprintf( NULL, 0, "%d", 12345 ) == 5 );
+
+	// sprintf has no size - nothing before or after the string may be touched
+
+	memset( out, 'x', sizeof( out ) );
+	CHECK( sprintf( out + 1, "%d", 42 ) == 2 && out[0] == 'x' && !strcmp( out + 1, "42" ) && out[4] == 'x' );
+}
+
+// Files, text mode CR/LF translation, seeking
+
+static void test_files( void )
+{
+	char line[32];
+	char raw[32];
+	FILE *f;
+	size_t n;
+
+	f = fopen( TEST_FILE, "w" );
+	CHECK( f != NULL );
+	if ( !f ) return;
+	CHECK( fprintf( f, "line one\n" ) == 9 );
+	CHECK( fprintf( f, "line %s\n", "two" ) == 9 );
+	CHECK( fclose( f ) == 0 );
+
+	f = fopen( TEST_FILE, "rb" );
+	n = fread( raw, 1, sizeof( raw ), f );
+	CHECK( n == 20 && !memcmp( raw, "line one\r\nline two\r\n", 20 ) );
+	fclose( f );
+
+	f = fopen( TEST_FILE, "r" );
+	CHECK( fgets( line, sizeof( line ), f ) && !strcmp( line, "line one\n" ) );
+	CHECK( ftell( f ) == 10 );
+	CHECK( fgets( line, sizeof( line ), f ) && !strcmp( line, "line two\n" ) );
+	CHECK( fgets( line, sizeof( line ), f ) == NULL && feof( f ) );
+	CHECK( fseek( f, 5, SEEK_SET ) == 0 && fgetc( f ) == 'o' && ftell( f ) == 6 );
+	CHECK( fseek( f, -2, SEEK_END ) == 0 && fgetc( f ) == '\n' );
+	fclose( f );
+
+	f = fopen( TEST_FILE, "a" );
+	fputc( '!', f );
+	fclose( f );
+	f = fopen( TEST_FILE, "rb" );
+	CHECK( fseek( f, 0, SEEK_END ) == 0 && ftell( f ) == 21 );
+	fclose( f );
+
+	CHECK( fopen( "no/such/dir/file", "r" ) == NULL );
+	CHECK( remove( TEST_FILE ) == 0 );
+	CHECK( fopen( TEST_FILE, "r" ) == NULL );
+
+	// A CR on its own in a text file is read as it is, without losing the character after it
+
+	f = fopen( TEST_FILE, "wb" );
+	fwrite( "a\rb\r\nc", 1, 6, f );
+	fclose( f );
+	f = fopen( TEST_FILE, "r" );
+	CHECK( fgets( line, sizeof( line ), f ) && !strcmp( line, "a\rb\n" ) );
+	CHECK( fgetc( f ) == 'c' && fgetc( f ) == EOF );
+	fclose( f );
+	remove( TEST_FILE );
+}
+
+// A character device (FH_DEVICE, e.g. ser_fopen) - CR alone or CR/LF is a line end. A CR is
+// returned without reading ahead (ser_fopen's device waits for a byte), and the LF of a CR/LF
+// is skipped when it's read, even if it arrives after a read that found no data
+
+extern int (*_stdio_dev_getc)( void );
+
+static const char *dev_data;
+
+static int dev_getc( void )
+{
+	return *dev_data ? (uint8_t)*dev_data++ : EOF;
+}
+
+static void test_device( void )
+{
+	FILE dev = { .fhandle = FH_DEVICE, .text_mode = 1 };
+
+	_stdio_dev_getc = dev_getc;
+	dev_data = "a\rb\r\nc\r";
+	CHECK( fgetc( &dev ) == 'a' && fgetc( &dev ) == '\n' && fgetc( &dev ) == 'b' );
+	CHECK( fgetc( &dev ) == '\n' && fgetc( &dev ) == 'c' );
+	CHECK( fgetc( &dev ) == '\n' && !feof( &dev ) );
+	CHECK( fgetc( &dev ) == EOF && feof( &dev ) );
+
+	dev.eof = 0;
+	dev_data = "x\r\n\ny";
+	CHECK( fgetc( &dev ) == 'x' && fgetc( &dev ) == '\n' && *dev_data == '\n' );
+	CHECK( fgetc( &dev ) == '\n' && fgetc( &dev ) == 'y' );
+
+	dev_data = "\r";
+	CHECK( fgetc( &dev ) == '\n' && fgetc( &dev ) == EOF );
+	dev.eof = 0;
+	dev_data = "\nz";
+	CHECK( fgetc( &dev ) == 'z' );
+	_stdio_dev_getc = NULL;
+}
+
+static void test_stdin( void )
+{
+	char line[32];
+
+	host_input( "12 abc\nxyz\n" );
+	CHECK( fgets( line, sizeof( line ), stdin ) && !strcmp( line, "12 abc\n" ) );
+	CHECK( fgetc( stdin ) == 'x' );
+	CHECK( fgets( line, sizeof( line ), stdin ) && !strcmp( line, "yz\n" ) );
+}
+
+static void test_strtok( void )
+{
+	char s[] = "  one,two;;three ";
+	char *t;
+
+	t = strtok( s, " ,;" );
+	CHECK( t && !strcmp( t, "one" ) );
+	t = strtok( NULL, " ,;" );
+	CHECK( t && !strcmp( t, "two" ) );
+	t = strtok( NULL, " ,;" );
+	CHECK( t && !strcmp( t, "three" ) );
+	CHECK( strtok( NULL, " ,;" ) == NULL );
+}
+
+// 2024-02-29 12:34:56 UTC is 1709210096
+
+static void test_time( void )
+{
+	RTC_DATA rtc = { .year = 44, .month = 1, .day = 29, .hour = 12, .minute = 34, .second = 56 };
+	struct tm tm = { .tm_year = 124, .tm_mon = 1, .tm_mday = 29, .tm_hour = 12, .tm_min = 34, .tm_sec = 56 };
+	time_t t = 1709210096;
+	struct tm *g;
+
+	CHECK( mktime( &tm ) == 1709210096 );
+
+	g = gmtime( &t );
+	CHECK( g->tm_year == 124 && g->tm_mon == 1 && g->tm_mday == 29 && g->tm_wday == 4 && g->tm_yday == 59 );
+	CHECK( g->tm_hour == 12 && g->tm_min == 34 && g->tm_sec == 56 );
+	t = 0;
+	g = gmtime( &t );
+	CHECK( g->tm_year == 70 && g->tm_mon == 0 && g->tm_mday == 1 && g->tm_wday == 4 );
+
+	host_rtc_set( &rtc );
+	host_clock_manual( true );
+	time_resync();
+	CHECK( time( NULL ) == 1709210096 );
+	host_clock_advance( 250 );
+	CHECK( time( NULL ) == 1709210098 );
+	host_clock_manual( false );
+	host_rtc_set( NULL );
+}
+
+// The VDU stream sent by vdp_vdu.c
+
+static bool sent( const uint8_t *buf, const uint8_t *expect, uint24_t len )
+{
+	return host_vdu_recorded() == len && !memcmp( buf, expect, len );
+}
+
+static void test_vdu( void )
+{
+	static const uint8_t mode[] = { 22, 8, 23, 0, 0x86 };
+	static const uint8_t tab[] = { 31, 3, 4, 17, 2 };
+	static const uint8_t point[] = { 25, 0x04, 0xD0, 0x07, 10, 0, 25, 0x45, 100, 0, 100, 0 };
+	static char batch[64];
+	uint8_t buf[64];
+	uint32_t calls;
+	int i;
+
+	host_vdu_record( buf, sizeof( buf ) );
+	vdp_mode( 8 );
+	vdp_get_scr_dims( true );
+	CHECK( sent( buf, mode, sizeof( mode ) ) );
+	CHECK( getsysvar_scrwidth() == 320 && getsysvar_scrheight() == 240 && getsysvar_scrColours() == 64 );
+
+	host_vdu_record( buf, sizeof( buf ) );
+	vdp_cursor_tab( 3, 4 );
+	vdp_set_text_colour( 2 );
+	CHECK( sent( buf, tab, sizeof( tab ) ) );
+	CHECK( getsysvar_cursorX() == 3 && getsysvar_cursorY() == 4 );
+
+	// With clipping on, off screen plots are dropped and the next one sent after a move. Once
+	// the graphics cursor is unknown, plots relative to it are sent
+
+	host_vdu_record( buf, sizeof( buf ) );
+	vdp_point( 2000, 10 );
+	CHECK( host_vdu_recorded() == 6 );
+	vdp_clip_enable( true );
+	host_vdu_record( buf, sizeof( buf ) );
+	vdp_point( 2000, 10 );
+	CHECK( host_vdu_recorded() == 0 );
+	vdp_point( 100, 100 );
+	CHECK( sent( buf, point, sizeof( point ) ) );
+
+	host_vdu_record( buf, sizeof( buf ) );
+	vdp_clip_invalidate();
+	vdp_plot( 0x41, 2000, 0 );
+	vdp_line_to( 2000, 2000 );
+	CHECK( host_vdu_recorded() == 12 );
+	vdp_point( 2000, 10 );
+	vdp_line_to( 2000, 2000 );
+	CHECK( host_vdu_recorded() == 12 );
+	vdp_clip_enable( false );
+
+	// One mos_puts per batch
+
+	calls = host_stats.vdu_calls;
+	vdp_batch_begin( batch, sizeof( batch ) );
+	for ( i = 0; i < 8; i++ ) vdp_point( i, i );
+	CHECK( host_stats.vdu_calls == calls );
+	vdp_batch_end();
+	CHECK( host_stats.vdu_calls == calls + 1 );
+
+	// Waiting for a reply sends the request in the batch, rather than waiting forever
+
+	vdp_batch_begin( batch, sizeof( batch ) );
+	vdp_mode( 1 );
+	vdp_get_scr_dims( true );
+	CHECK( getsysvar_scrwidth() == 640 && getsysvar_scrColours() == 4 );
+	vdp_batch_end();
+
+	host_vdu_record( NULL, 0 );
+}
+
+static void test_keys( void )
+{
+	CHECK( vdp_key_init() == -1 );					// no MOS UART0 handler to take over
+
+	kb_Reset();
+	host_key( KB_KEY_LETTER( 'a' ), true );
+	kb_Scan();
+	CHECK( kb_IsDown( KB_KEY_LETTER( 'a' ) ) && kb_IsPressed( KB_KEY_LETTER( 'a' ) ) );
+	CHECK( vdp_check_key_press( KB_KEY_LETTER( 'A' ) ) );
+	kb_Scan();
+	CHECK( kb_IsDown( KB_KEY_LETTER( 'a' ) ) && !kb_IsPressed( KB_KEY_LETTER( 'a' ) ) );
+	host_key( KB_KEY_LETTER( 'a' ), false );
+	kb_Scan();
+	CHECK( !kb_IsDown( KB_KEY_LETTER( 'a' ) ) && kb_IsReleased( KB_KEY_LETTER( 'a' ) ) );
+
+	// With shift the VDP reports VK_A - VK_Z (0x30 on), which count as the unshifted letter
+
+	host_key( 0x30, true );
+	host_key( 0x49, true );
+	kb_Scan();
+	CHECK( kb_IsPressed( KB_KEY_LETTER( 'a' ) ) && kb_IsDown( KB_KEY_LETTER( 'Z' ) ) && !kb_IsDown( KB_KEY_LETTER( 'b' ) ) );
+	host_key( 0x30, false );
+	host_key( 0x49, false );
+	kb_Scan();
+	CHECK( kb_IsReleased( KB_KEY_LETTER( 'a' ) ) && !kb_IsDown( KB_KEY_LETTER( 'z' ) ) );
+}
+
+int main( void )
+{
+	test_printf();
+	test_files();
+	test_device();
+	test_stdin();
+	test_strtok();
+	test_time();
+	test_vdu();
+	test_keys();
+
+	printf( "host_test: %d checks, %d failed\n", checks, failures );
+	return failures != 0;
+}
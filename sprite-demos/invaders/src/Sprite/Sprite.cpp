@@ -17,6 +17,40 @@ int Sprite::sprites_num = 0;
 int Sprite::sprites_next_free = 0;
 Sprite **Sprite::sprites_vdp = NULL;
 
+// Off-screen culling
+// - a sprite that moves completely off the screen is hidden once, and its moves aren't sent to
+//   the VDP until it comes back on, when it's moved to where it is and shown again
+// - the screen size is read from the sysvars by init(), culling is off if it isn't known
+
+static int cull_w = 0, cull_h = 0;
+static uint8_t *sprites_culled = NULL;				// by VDP sprite id
+
+enum { CULL_ON, CULL_OFF, CULL_BACK };
+
+static int cull_check( int id, int x, int y, int w, int h, bool shown )
+{
+	bool off = cull_w && ( x >= cull_w || y >= cull_h || x + w <= 0 || y + h <= 0 );
+
+	if ( off ) {
+		if ( !sprites_culled[id] ) {
+			sprites_culled[id] = 1;
+			if ( shown ) {
+				vdp_select_sprite( id );
+				vdp_hide_sprite();
+			}
+		}
+		return CULL_OFF;
+	}
+	if ( sprites_culled[id] ) {
+		sprites_culled[id] = 0;
+		vdp_select_sprite( id );
+		vdp_move_sprite_to( x, y );
+		if ( shown ) vdp_show_sprite();
+		return CULL_BACK;
+	}
+	return CULL_ON;
+}
+
 // Constructors, destructors & associated helper functions
 
 int Sprite::init( int num_sprites )
@@ -25,6 +59,9 @@ int Sprite::init( int num_sprites )
 	sprites_max_num = num_sprites;
 
 	if ( !(sprites_vdp = (Sprite **)calloc( sprites_max_num, sizeof(Sprite *) )) ) return 0;
+	if ( !(sprites_culled = (uint8_t *)calloc( sprites_max_num, 1 )) ) return 0;
+	cull_w = getsysvar_scrwidth();
+	cull_h = getsysvar_scrheight();
 	return sprites_max_num;
 }
 
@@ -62,6 +99,7 @@ void Sprite::set_details( int x, int y, int dx, int dy, int width, int height, i
 		exit( 1 );
 	}
 	sprites_vdp[s_vdp_id] = this;
+	sprites_culled[s_vdp_id] = 0;
 	sprites_num++;
 
 	s_x = x; s_y = y;
@@ -163,8 +201,10 @@ void Sprite::add_bitmaps( int bitmap_id, int num, int die )
 void Sprite::show()
 {
 	if ( !visible ) {
-		vdp_select_sprite( s_vdp_id );
-		vdp_show_sprite();
+		if ( !sprites_culled[s_vdp_id] ) {
+			vdp_select_sprite( s_vdp_id );
+			vdp_show_sprite();
+		}
 		visible = true;
 	}
 }
@@ -172,8 +212,10 @@ void Sprite::show()
 void Sprite::hide()
 {
 	if ( visible ) {
-		vdp_select_sprite( s_vdp_id );
-		vdp_hide_sprite();
+		if ( !sprites_culled[s_vdp_id] ) {
+			vdp_select_sprite( s_vdp_id );
+			vdp_hide_sprite();
+		}
 		visible = false;
 	}
 }
@@ -184,6 +226,7 @@ void Sprite::move_to( int xcoord, int ycoord )
 {
 	s_x = xcoord;
 	s_y = ycoord;
+	if ( cull_check( s_vdp_id, s_x, s_y, s_w, s_h, visible && state != DEAD ) != CULL_ON ) return;
 	vdp_select_sprite( s_vdp_id );
 	vdp_move_sprite_to( xcoord, ycoord );
 }
@@ -200,6 +243,7 @@ void Sprite::move_by( int dx, int dy )
 		if ( s_y + s_h >= sprite_grp->sg_y1 ) at_bottom();
 		else if ( s_y < sprite_grp->sg_y0 ) at_top();
 	}
+	if ( cull_check( s_vdp_id, s_x, s_y, s_w, s_h, visible && state != DEAD ) != CULL_ON ) return;
 	vdp_select_sprite( s_vdp_id );
 	vdp_move_sprite_by( dx, dy );
 }
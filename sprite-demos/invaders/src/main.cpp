@@ -76,10 +76,11 @@ void game_loop()
 		ship->next_frame();
 		for ( int s = 0; s < 4; s++ ) {
 			int dx = 0, dy = 0;
-			if ( vdp_check_key_press( 0x9c ) ) dx = 3;								// right
-			if ( vdp_check_key_press( 0x9a ) ) dx -= 3;								// left
-			if ( vdp_check_key_press( 0x96 ) ) dy = -3;								// up
-			if ( vdp_check_key_press( 0x98 ) ) dy += 3;				 				// down
+			kb_Scan();																// snapshot keys once per step
+			if ( kb_IsDown( KB_KEY_RIGHT ) ) dx = 3;
+			if ( kb_IsDown( KB_KEY_LEFT ) ) dx -= 3;
+			if ( kb_IsDown( KB_KEY_UP ) ) dy = -3;
+			if ( kb_IsDown( KB_KEY_DOWN ) ) dy += 3;
 			ship->move_by( dx, dy );
 
 			bullets->hit( aliens );
@@ -0,0 +1,205 @@
+// Deferred format binary logging - see dlog.h for the log format
+//
+// - the ring is a power of 2 in size, so the head and tail indexes just count up and are masked
+// - a record is only written if it fits whole, so the reader never sees part of one
+// - after a drop, the count is logged ahead of the next record that fits
+
+#include <agon/dlog.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+#define DLOG_VERSION	1
+#define DLOG_HEADER		8				// fmt, time, count, types
+#define DLOG_CHUNK		256				// bytes per sink call
+#define DLOG_FLUSH_TIMEOUT	100			// centiseconds
+
+static const char dlog_marker[] = DLOG_MARKER;
+
+static uint8_t *ring = NULL;
+static uint24_t ring_mask;
+static uint24_t head;					// next byte to write
+static uint24_t tail;					// next byte to send
+
+static uint24_t dropped_total;
+static uint24_t dropped_pending;		// not yet logged
+
+static DLOG_SINK dlog_sink = NULL;
+static uint8_t dlog_fh = 0;
+static bool dlog_atexit_done = false;
+
+static const uint8_t arg_size[4] = { 3, 4, 4, 3 };
+
+bool dlog_init( void *buf, uint24_t size )
+{
+	uint24_t n = 1;
+
+	if ( !buf || size < 64 ) return false;
+	while ( n <= size / 2 ) n <<= 1;
+
+	ring = buf;
+	ring_mask = n - 1;
+	head = tail = 0;
+	dropped_total = dropped_pending = 0;
+	return true;
+}
+
+static inline void put( uint8_t b )
+{
+	ring[head++ & ring_mask] = b;
+}
+
+static inline void put24( uint24_t v )
+{
+	put( v );
+	put( v >> 8 );
+	put( v >> 16 );
+}
+
+static void put_header( const char *fmt, uint24_t time, uint24_t desc )
+{
+	put24( (uint24_t)fmt );
+	put24( time );
+	put( desc );
+	put( desc >> 8 );
+}
+
+void dlog_record( const char *fmt, uint24_t desc, ... )
+{
+	uint8_t count = desc & 7;
+	uint8_t types = desc >> 8;
+	uint24_t len = DLOG_HEADER;
+	uint24_t space;
+	uint24_t time;
+	va_list ap;
+	uint8_t i;
+
+	if ( !ring ) return;
+	for ( i = 0; i < count; i++ ) len += arg_size[( types >> ( i * 2 ) ) & 3];
+
+	space = ring_mask + 1 - ( head - tail );
+	if ( dropped_pending ) len += DLOG_HEADER + 4;
+	if ( len > space ) {
+		dropped_total++;
+		dropped_pending++;
+		return;
+	}
+
+	time = getsysvar_time();
+	if ( dropped_pending ) {
+		put_header( NULL, time, 1 | DLOG_LONG << 8 );
+		put24( dropped_pending );
+		put( 0 );
+		dropped_pending = 0;
+	}
+	put_header( fmt, time, desc );
+
+	va_start( ap, desc );
+	for ( i = 0; i < count; i++ ) {
+		uint32_t v = va_arg( ap, uint32_t );
+
+		put24( v );
+		if ( arg_size[( types >> ( i * 2 ) ) & 3] == 4 ) put( v >> 24 );
+	}
+	va_end( ap );
+}
+
+static int dlog_file_write( const void *buf, int len )
+{
+	return mos_fwrite( dlog_fh, (char *)buf, len );
+}
+
+static void dlog_start( DLOG_SINK sink )
+{
+	uint8_t header[8] = { 'A', 'G', 'D', 'L', DLOG_VERSION };
+	uint24_t marker = (uint24_t)dlog_marker;
+	int n = 0;
+
+	header[5] = marker;
+	header[6] = marker >> 8;
+	header[7] = marker >> 16;
+
+	dlog_sink = sink;
+	while ( n < (int)sizeof( header ) ) {
+		int w = sink( header + n, sizeof( header ) - n );
+
+		if ( w <= 0 ) break;
+		n += w;
+	}
+
+	if ( !dlog_atexit_done ) {
+		atexit( &dlog_close );
+		dlog_atexit_done = true;
+	}
+}
+
+bool dlog_open( const char *fname )
+{
+	dlog_close();
+	dlog_fh = mos_fopen( fname, FA_WRITE | FA_CREATE_ALWAYS );
+	if ( !dlog_fh ) return false;
+	dlog_start( dlog_file_write );
+	return true;
+}
+
+void dlog_open_sink( DLOG_SINK sink )
+{
+	dlog_close();
+	if ( sink ) dlog_start( sink );
+}
+
+uint24_t dlog_poll( uint24_t max )
+{
+	uint24_t done = 0;
+
+	if ( !ring || !dlog_sink ) return 0;
+
+	while ( done < max && head != tail ) {
+		uint24_t start = tail & ring_mask;
+		uint24_t len = head - tail;
+		int n;
+
+		// Up to the end of the ring, the end of the data or the limit, whichever is first
+
+		if ( len > ring_mask + 1 - start ) len = ring_mask + 1 - start;
+		if ( len > max - done ) len = max - done;
+		if ( len > DLOG_CHUNK ) len = DLOG_CHUNK;
+
+		n = dlog_sink( ring + start, len );
+		if ( n <= 0 ) break;				// sink full (e.g. serial TX ring), try next time
+		tail += n;
+		done += n;
+	}
+	return done;
+}
+
+// Gives up if the sink takes nothing for DLOG_FLUSH_TIMEOUT (e.g. a disk error)
+
+void dlog_flush( void )
+{
+	uint32_t last = getsysvar_time();
+
+	while ( dlog_sink && head != tail ) {
+		if ( dlog_poll( head - tail ) ) last = getsysvar_time();
+		else if ( getsysvar_time() - last > DLOG_FLUSH_TIMEOUT ) break;
+	}
+}
+
+void dlog_close( void )
+{
+	dlog_flush();
+	if ( dlog_fh ) {
+		mos_fclose( dlog_fh );
+		dlog_fh = 0;
+	}
+	dlog_sink = NULL;
+}
+
+uint24_t dlog_pending( void )
+{
+	return head - tail;
+}
+
+uint24_t dlog_dropped( void )
+{
+	return dropped_total;
+}
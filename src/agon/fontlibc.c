@@ -0,0 +1,655 @@
+// FontLibC for the Agon VDP
+//
+// - glyphs are uploaded once, when a font is set, as 1-bit bitmaps held in VDP buffers
+//   (buffer font_base + code point); the fontlib glyph rows are already in the VDP mono format
+// - strings are sent as one stream of "select bitmap" + relative "plot bitmap" commands,
+//   collected in a small command buffer so a whole line goes out in one or two mos_puts
+// - the same stream can be written into a VDP buffer instead and replayed with one call
+//   (fontlib_CacheString / fontlib_DrawCachedString)
+// - coordinates are screen pixels, so logical screen scaling must be off
+
+#include <fontlibc.h>
+#include <vdp_vdu.h>
+#include <mos_api.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FONTLIB_DEFAULT_BASE	0xF800
+#define FONTLIB_MONO_FORMAT		2
+#define FONTLIB_CMD_BUF_SIZE	128
+
+#define PLOT_MOVE_ABS			0x04
+#define PLOT_RECT_FILL_ABS		0x65
+#define PLOT_BITMAP_REL			0xE9
+
+// Current font
+
+static const fontlib_font_t *font = NULL;
+static const uint8_t *font_widths;
+static const uint16_t *font_bitmaps;
+static unsigned int font_glyphs;
+static uint16_t font_base = FONTLIB_DEFAULT_BASE;
+
+static const fontlib_kern_pair_t *kern_pairs = NULL;
+static size_t kern_count = 0;
+
+static uint16_t cache_width[FONTLIB_CACHE_SLOTS];
+
+// Text window, cursor and drawing options
+
+static unsigned int win_x = 0;
+static unsigned int win_y = 0;
+static unsigned int win_w = 0;
+static unsigned int win_h = 0;
+static unsigned int cur_x = 0;
+static unsigned int cur_y = 0;
+
+static uint8_t fg_colour = 15;
+static uint8_t bg_colour = 0;
+static bool transparent = true;
+static uint8_t space_above = 0;
+static uint8_t space_below = 0;
+static uint8_t italic_adjust = 0;
+static uint8_t newline_options = FONTLIB_ENABLE_AUTO_WRAP;
+static char newline_code = 0x0A;
+static char alt_stop_code = 0;
+static char first_printable = 0x10;
+static char draw_int_minus = '-';
+static char draw_int_zero = '0';
+
+static const char *last_char_read = NULL;
+static size_t chars_remaining = 0;
+
+// Command buffer - flushed to the screen, or to a VDP buffer when caching a string
+
+static uint8_t cmd_buf[FONTLIB_CMD_BUF_SIZE];
+static uint8_t cmd_len = 0;
+static int cmd_target = -1;
+
+static void cmd_flush( void )
+{
+	if ( !cmd_len ) return;
+	if ( cmd_target >= 0 ) vdp_adv_write_block( cmd_target, cmd_len );
+	else vdp_clip_invalidate();			// the glyph plots move the graphics cursor
+	vdp_write( cmd_buf, cmd_len );
+	cmd_len = 0;
+}
+
+static void cmd_reserve( uint8_t len )
+{
+	if ( cmd_len + len > FONTLIB_CMD_BUF_SIZE ) cmd_flush();
+}
+
+static void cmd_byte( uint8_t b )
+{
+	cmd_buf[cmd_len++] = b;
+}
+
+static void cmd_word( int w )
+{
+	cmd_buf[cmd_len++] = w;
+	cmd_buf[cmd_len++] = w >> 8;
+}
+
+static void cmd_plot( uint8_t mode, int x, int y )
+{
+	cmd_reserve( 5 );
+	cmd_byte( 25 );
+	cmd_byte( mode );
+	cmd_word( x );
+	cmd_word( y );
+}
+
+static void cmd_gcol( uint8_t colour )
+{
+	cmd_reserve( 3 );
+	cmd_byte( 18 );
+	cmd_byte( 0 );
+	cmd_byte( colour );
+}
+
+static void cmd_glyph( uint8_t glyph, int dx )
+{
+	cmd_reserve( 11 );
+	cmd_byte( 23 );							// select bitmap by buffer ID
+	cmd_byte( 27 );
+	cmd_byte( 0x20 );
+	cmd_word( font_base + glyph );
+	cmd_byte( 25 );							// plot it relative to the last glyph
+	cmd_byte( PLOT_BITMAP_REL );
+	cmd_word( dx );
+	cmd_word( 0 );
+}
+
+// Font metrics
+
+static unsigned int line_height( void )
+{
+	return font->height + space_above + space_below;
+}
+
+static uint8_t glyph_width( uint8_t c )
+{
+	uint8_t index;
+
+	if ( !font ) return 0;
+	index = c - font->first_glyph;
+	if ( index >= font_glyphs ) return 0;
+	return font_widths[index];
+}
+
+static int kerning( uint8_t left, uint8_t right )
+{
+	size_t lo = 0, hi = kern_count;
+	unsigned int key = (left << 8) | right;
+
+	while ( lo < hi ) {
+		size_t mid = (lo + hi) >> 1;
+		unsigned int k = (kern_pairs[mid].left << 8) | kern_pairs[mid].right;
+		if ( k == key ) return kern_pairs[mid].adjust;
+		if ( k < key ) lo = mid + 1;
+		else hi = mid;
+	}
+	return 0;
+}
+
+static int glyph_advance( uint8_t c, uint8_t next )
+{
+	int adv = glyph_width( c ) - italic_adjust;
+	if ( kern_count && next ) adv += kerning( c, next );
+	return adv;
+}
+
+static bool is_stop_code( char c )
+{
+	return !c || c == alt_stop_code || (uint8_t)c < (uint8_t)first_printable;
+}
+
+// Measure the run of printable glyphs from str that fits in space pixels
+// - returns the number of characters in the run and sets *width
+
+static size_t fit_run( const char *str, size_t max_chars, unsigned int space, unsigned int *width )
+{
+	const char *s = str;
+	unsigned int x = 0;
+
+	while ( max_chars && !is_stop_code( *s ) ) {
+		uint8_t w = glyph_width( *s );
+		if ( !w && !fontlib_ValidateCodePoint( *s ) ) break;
+		if ( x + w > space ) break;
+		x += glyph_advance( s[0], max_chars > 1 && !is_stop_code( s[1] ) ? s[1] : 0 );
+		s++;
+		max_chars--;
+	}
+	*width = x;
+	return s - str;
+}
+
+// Emit the glyphs of a run already known to fit at the cursor
+
+static void emit_glyphs( const char *s, size_t n )
+{
+	int dx = 0;
+
+	while ( n-- ) {
+		uint8_t c = *s++;
+		if ( glyph_width( c ) ) {
+			cmd_glyph( c, dx );
+			dx = 0;
+		}
+		dx += glyph_advance( c, n ? *s : 0 );
+	}
+}
+
+static void emit_background( unsigned int width )
+{
+	if ( transparent || !width ) return;
+	cmd_gcol( bg_colour );
+	cmd_plot( PLOT_MOVE_ABS, cur_x, cur_y );
+	cmd_plot( PLOT_RECT_FILL_ABS, cur_x + width - 1, cur_y + line_height() - 1 );
+}
+
+static void emit_run( const char *s, size_t n, unsigned int width )
+{
+	emit_background( width );
+	cmd_gcol( fg_colour );
+	cmd_plot( PLOT_MOVE_ABS, cur_x, cur_y + space_above );
+	emit_glyphs( s, n );
+	cur_x += width;
+}
+
+// Upload every glyph of the current font to the VDP
+
+static void upload_glyphs( void )
+{
+	const uint8_t *base = (const uint8_t *)font;
+
+	for ( unsigned int i = 0; i < font_glyphs; i++ ) {
+		uint8_t w = font_widths[i];
+		if ( !w ) continue;
+
+		int id = font_base + (uint8_t)(font->first_glyph + i);
+		int size = ((w + 7) >> 3) * font->height;
+
+		vdp_adv_clear_buffer( id );
+		vdp_adv_write_block( id, size );
+		vdp_write( base + font_bitmaps[i], size );
+		vdp_adv_select_bitmap( id );
+		vdp_adv_bitmap_from_buffer( w, font->height, FONTLIB_MONO_FORMAT );
+	}
+}
+
+// Text window and cursor
+
+void fontlib_SetWindowFullScreen( void )
+{
+	volatile SYSVAR *sys_vars = vdp_vdu_init();
+
+	win_x = 0;
+	win_y = 0;
+	win_w = sys_vars->scrWidth;
+	win_h = sys_vars->scrHeight;
+}
+
+void fontlib_SetWindow( unsigned int x_min, unsigned int y_min, unsigned int width, unsigned int height )
+{
+	win_x = x_min;
+	win_y = y_min;
+	win_w = width;
+	win_h = height;
+}
+
+unsigned int fontlib_GetWindowXMin( void ) { return win_x; }
+unsigned int fontlib_GetWindowYMin( void ) { return win_y; }
+unsigned int fontlib_GetWindowWidth( void ) { return win_w; }
+unsigned int fontlib_GetWindowHeight( void ) { return win_h; }
+
+void fontlib_SetCursorPosition( unsigned int x, unsigned int y )
+{
+	cur_x = x;
+	cur_y = y;
+}
+
+unsigned int fontlib_GetCursorX( void ) { return cur_x; }
+unsigned int fontlib_GetCursorY( void ) { return cur_y; }
+
+void fontlib_ShiftCursorPosition( int x, int y )
+{
+	cur_x += x;
+	cur_y += y;
+}
+
+void fontlib_HomeUp( void )
+{
+	cur_x = win_x;
+	cur_y = win_y;
+}
+
+void fontlib_Home( void ) { cur_x = win_x; }
+
+// Font selection
+
+void fontlib_SetBitmapBase( uint16_t buffer_id ) { font_base = buffer_id; }
+
+bool fontlib_SetFont( const fontlib_font_t *font_data, fontlib_load_options_t flags )
+{
+	font = NULL;
+	if ( !font_data || font_data->fontVersion != 0 || !font_data->height ) return false;
+
+	font = font_data;
+	font_widths = (const uint8_t *)font + font->widths_table;
+	font_bitmaps = (const uint16_t *)((const uint8_t *)font + font->bitmaps);
+	font_glyphs = font->total_glyphs ? font->total_glyphs : 256;
+
+	if ( flags & FONTLIB_IGNORE_LINE_SPACING ) {
+		space_above = 0;
+		space_below = 0;
+	} else {
+		space_above = font->space_above;
+		space_below = font->space_below;
+	}
+	italic_adjust = font->italic_space_adjust;
+	if ( !win_w ) fontlib_SetWindowFullScreen();
+
+	upload_glyphs();
+	return true;
+}
+
+void fontlib_SetKerning( const fontlib_kern_pair_t *pairs, size_t count )
+{
+	kern_pairs = pairs;
+	kern_count = pairs ? count : 0;
+}
+
+// Colours and spacing
+
+void fontlib_SetForegroundColor( uint8_t color ) { fg_colour = color; }
+void fontlib_SetBackgroundColor( uint8_t color ) { bg_colour = color; }
+
+void fontlib_SetColors( uint8_t forecolor, uint8_t backcolor )
+{
+	fg_colour = forecolor;
+	bg_colour = backcolor;
+}
+
+uint8_t fontlib_GetForegroundColor( void ) { return fg_colour; }
+uint8_t fontlib_GetBackgroundColor( void ) { return bg_colour; }
+void fontlib_SetTransparency( bool transparency ) { transparent = transparency; }
+bool fontlib_GetTransparency( void ) { return transparent; }
+
+void fontlib_SetLineSpacing( uint8_t above, uint8_t below )
+{
+	space_above = above;
+	space_below = below;
+}
+
+uint8_t fontlib_GetSpaceAbove( void ) { return space_above; }
+uint8_t fontlib_GetSpaceBelow( void ) { return space_below; }
+void fontlib_SetItalicSpacingAdjustment( uint8_t adjustment ) { italic_adjust = adjustment; }
+uint8_t fontlib_GetItalicSpacingAdjustment( void ) { return italic_adjust; }
+
+uint8_t fontlib_GetCurrentFontHeight( void )
+{
+	if ( !font ) return 0;
+	return line_height();
+}
+
+bool fontlib_ValidateCodePoint( char code_point )
+{
+	if ( !font ) return false;
+	return (uint8_t)((uint8_t)code_point - font->first_glyph) < font_glyphs;
+}
+
+size_t fontlib_GetTotalGlyphs( void ) { return font ? font_glyphs : 0; }
+char fontlib_GetFirstGlyph( void ) { return font ? font->first_glyph : 0; }
+
+void fontlib_SetNewlineCode( char code_point ) { newline_code = code_point; }
+char fontlib_GetNewlineCode( void ) { return newline_code; }
+void fontlib_SetAlternateStopCode( char code_point ) { alt_stop_code = code_point; }
+char fontlib_GetAlternateStopCode( void ) { return alt_stop_code; }
+void fontlib_SetFirstPrintableCodePoint( char code_point ) { first_printable = code_point; }
+char fontlib_GetFirstPrintableCodePoint( void ) { return first_printable; }
+
+void fontlib_SetDrawIntCodePoints( char minus, char zero )
+{
+	draw_int_minus = minus;
+	draw_int_zero = zero;
+}
+
+char fontlib_GetDrawIntMinus( void ) { return draw_int_minus; }
+char fontlib_GetDrawIntZero( void ) { return draw_int_zero; }
+void fontlib_SetNewlineOptions( uint8_t options ) { newline_options = options; }
+uint8_t fontlib_GetNewlineOptions( void ) { return newline_options; }
+
+// Measuring
+
+uint8_t fontlib_GetGlyphWidth( char codepoint ) { return glyph_width( codepoint ); }
+
+unsigned int fontlib_GetStringWidthL( const char *str, size_t max_characters )
+{
+	unsigned int width;
+	size_t n;
+
+	if ( !font ) return 0;
+	n = fit_run( str, max_characters, (unsigned int)-1, &width );
+	last_char_read = str + n;
+	chars_remaining = max_characters - n;
+	return width;
+}
+
+unsigned int fontlib_GetStringWidth( const char *str )
+{
+	return fontlib_GetStringWidthL( str, (size_t)-1 );
+}
+
+char *fontlib_GetLastCharacterRead( void ) { return (char *)last_char_read; }
+size_t fontlib_GetCharactersRemaining( void ) { return chars_remaining; }
+
+// Drawing
+
+uint24_t fontlib_DrawGlyph( uint8_t glyph )
+{
+	char c = glyph;
+
+	if ( !font ) return cur_x;
+	emit_run( &c, 1, glyph_advance( glyph, 0 ) );
+	cmd_flush();
+	return cur_x;
+}
+
+uint24_t fontlib_DrawStringL( const char *str, size_t max_characters )
+{
+	unsigned int width;
+	size_t n;
+
+	if ( !font ) return cur_x;
+
+	for ( ;; ) {
+		n = fit_run( str, max_characters, win_x + win_w - cur_x, &width );
+		if ( n ) emit_run( str, n, width );
+		str += n;
+		max_characters -= n;
+		if ( !max_characters || !*str || *str == alt_stop_code ) break;
+
+		if ( *str == newline_code ) {
+			str++;
+			max_characters--;
+		} else if ( !(newline_options & FONTLIB_ENABLE_AUTO_WRAP) || is_stop_code( *str )
+					|| !fontlib_ValidateCodePoint( *str ) || cur_x == win_x ) {
+			break;
+		}
+		if ( fontlib_Newline() ) break;
+	}
+	cmd_flush();
+	last_char_read = str;
+	chars_remaining = max_characters;
+	return cur_x;
+}
+
+uint24_t fontlib_DrawString( const char *str )
+{
+	return fontlib_DrawStringL( str, (size_t)-1 );
+}
+
+void fontlib_DrawUInt( unsigned int n, uint8_t length )
+{
+	char digits[8];
+	uint8_t i = sizeof(digits);
+	unsigned int width = 0;
+
+	if ( !font ) return;
+	do {
+		digits[--i] = draw_int_zero + n % 10;
+		n /= 10;
+	} while ( (n || sizeof(digits) - i < length) && i );
+
+	for ( uint8_t j = i; j < sizeof(digits); j++ ) width += glyph_advance( digits[j], 0 );
+	emit_run( digits + i, sizeof(digits) - i, width );
+	cmd_flush();
+}
+
+void fontlib_DrawInt( int n, uint8_t length )
+{
+	unsigned int u = n;
+
+	if ( n < 0 ) {
+		fontlib_DrawGlyph( draw_int_minus );
+		u = 0u - u;							// -n overflows for INT_MIN
+		if ( length > 1 ) length--;
+	}
+	fontlib_DrawUInt( u, length );
+}
+
+static void clear_rect( unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1 )
+{
+	if ( x1 <= x0 || y1 <= y0 ) return;
+	cmd_gcol( bg_colour );
+	cmd_plot( PLOT_MOVE_ABS, x0, y0 );
+	cmd_plot( PLOT_RECT_FILL_ABS, x1 - 1, y1 - 1 );
+	cmd_flush();
+}
+
+void fontlib_ClearEOL( void )
+{
+	if ( !font ) return;
+	clear_rect( cur_x, cur_y, win_x + win_w, cur_y + line_height() );
+}
+
+void fontlib_ClearWindow( void )
+{
+	clear_rect( win_x, win_y, win_x + win_w, win_y + win_h );
+}
+
+// Scrolling uses the VDP scroll on the graphics viewport, which is left set to the text window
+
+static void scroll_window( int direction )
+{
+	if ( !font ) return;
+	cmd_flush();
+	vdp_set_graphics_viewport( win_x, win_y + win_h - 1, win_x + win_w - 1, win_y );
+	vdp_scroll_screen_extent( 2, direction, line_height() );
+}
+
+void fontlib_ScrollWindowDown( void ) { scroll_window( 3 ); }
+void fontlib_ScrollWindowUp( void ) { scroll_window( 2 ); }
+
+bool fontlib_Newline( void )
+{
+	if ( !font ) return true;
+
+	unsigned int height = line_height();
+
+	if ( newline_options & FONTLIB_AUTO_CLEAR_TO_EOL ) fontlib_ClearEOL();
+	if ( cur_y + 2 * height > win_y + win_h ) {
+		if ( !(newline_options & FONTLIB_AUTO_SCROLL) ) return true;
+		fontlib_ScrollWindowDown();
+	} else {
+		cur_y += height;
+	}
+	cur_x = win_x;
+	if ( newline_options & FONTLIB_PRECLEAR_NEWLINE ) fontlib_ClearEOL();
+	return false;
+}
+
+// Cached strings - the glyph stream is written to VDP buffer font_base + 256 + slot
+
+uint24_t fontlib_DrawCachedString( uint8_t slot )
+{
+	if ( slot >= FONTLIB_CACHE_SLOTS || !cache_width[slot] ) return cur_x;
+
+	emit_background( cache_width[slot] );
+	cmd_gcol( fg_colour );
+	cmd_plot( PLOT_MOVE_ABS, cur_x, cur_y + space_above );
+	cmd_reserve( 6 );
+	cmd_byte( 23 );							// call buffer
+	cmd_byte( 0 );
+	cmd_byte( 0xA0 );
+	cmd_word( font_base + 256 + slot );
+	cmd_byte( 1 );
+	cmd_flush();
+	cur_x += cache_width[slot];
+	return cur_x;
+}
+
+unsigned int fontlib_CacheString( uint8_t slot, const char *str )
+{
+	unsigned int width;
+	size_t n;
+
+	if ( !font || slot >= FONTLIB_CACHE_SLOTS ) return 0;
+
+	fontlib_FreeCachedString( slot );
+	n = fit_run( str, (size_t)-1, (unsigned int)-1, &width );
+
+	cmd_target = font_base + 256 + slot;
+	emit_glyphs( str, n );
+	cmd_flush();
+	cmd_target = -1;
+
+	cache_width[slot] = width;
+	return width;
+}
+
+void fontlib_FreeCachedString( uint8_t slot )
+{
+	if ( slot >= FONTLIB_CACHE_SLOTS ) return;
+	vdp_adv_clear_buffer( font_base + 256 + slot );
+	cache_width[slot] = 0;
+}
+
+// Font packs - loaded from file; the most recently used pack is kept in memory
+
+static fontlib_font_pack_t *pack_data = NULL;
+static char pack_name[32];
+
+static const fontlib_font_pack_t *load_font_pack( const char *name )
+{
+	FILE *fp;
+	long size;
+
+	if ( pack_data && !strcmp( name, pack_name ) ) return pack_data;
+
+	free( pack_data );
+	pack_data = NULL;
+	if ( strlen( name ) >= sizeof(pack_name) ) return NULL;
+	if ( !(fp = fopen( name, "rb" )) ) return NULL;
+
+	fseek( fp, 0, SEEK_END );
+	size = ftell( fp );
+	fseek( fp, 0, SEEK_SET );
+
+	if ( size > (long)sizeof(fontlib_font_pack_t) && (pack_data = malloc( size )) ) {
+		if ( fread( pack_data, 1, size, fp ) != (size_t)size || memcmp( pack_data->header, "FONTPACK", 8 ) ) {
+			free( pack_data );
+			pack_data = NULL;
+		}
+	}
+	fclose( fp );
+	if ( pack_data ) strcpy( pack_name, name );
+	return pack_data;
+}
+
+char *fontlib_GetFontPackName( const char *font_pack_name )
+{
+	const fontlib_font_pack_t *pack = load_font_pack( font_pack_name );
+	const fontlib_metadata_t *metadata;
+
+	if ( !pack || !pack->metadata ) return NULL;
+	metadata = (const fontlib_metadata_t *)((const char *)pack + pack->metadata);
+	if ( metadata->length < (int24_t)(2 * sizeof(int24_t)) || !metadata->font_family_name ) return NULL;
+	return (char *)pack + metadata->font_family_name;
+}
+
+fontlib_font_t *fontlib_GetFontByIndexRaw( const fontlib_font_pack_t *font_pack, uint8_t index )
+{
+	if ( !font_pack || index >= font_pack->fontCount ) return NULL;
+	return (fontlib_font_t *)((const char *)font_pack + font_pack->font_list[index]);
+}
+
+fontlib_font_t *fontlib_GetFontByIndex( const char *font_pack_name, uint8_t index )
+{
+	return fontlib_GetFontByIndexRaw( load_font_pack( font_pack_name ), index );
+}
+
+fontlib_font_t *fontlib_GetFontByStyleRaw( const fontlib_font_pack_t *font_pack, uint8_t size_min, uint8_t size_max,
+			uint8_t weight_min, uint8_t weight_max, uint8_t style_bits_set, uint8_t style_bits_reset )
+{
+	if ( !font_pack ) return NULL;
+
+	for ( uint8_t i = 0; i < font_pack->fontCount; i++ ) {
+		fontlib_font_t *f = fontlib_GetFontByIndexRaw( font_pack, i );
+		if ( f->height < size_min || f->height > size_max ) continue;
+		if ( f->weight < weight_min || f->weight > weight_max ) continue;
+		if ( (f->style & style_bits_set) != style_bits_set || (f->style & style_bits_reset) ) continue;
+		return f;
+	}
+	return NULL;
+}
+
+fontlib_font_t *fontlib_GetFontByStyle( const char *font_pack_name, uint8_t size_min, uint8_t size_max,
+			uint8_t weight_min, uint8_t weight_max, uint8_t style_bits_set, uint8_t style_bits_reset )
+{
+	return fontlib_GetFontByStyleRaw( load_font_pack( font_pack_name ), size_min, size_max,
+			weight_min, weight_max, style_bits_set, style_bits_reset );
+}
@@ -0,0 +1,164 @@
+// Batched I2C transactions for the eZ80 I2C controller
+//
+// - the controller is used with IEN clear and IFLG polled, so a whole transaction list runs
+//   without returning to MOS between bytes or segments
+// - status codes are from the eZ80F92 product specification (I2C_SR)
+
+#include <agon/i2c.h>
+#include <agon/ports.h>
+#include <stdbool.h>
+
+// I2C_CTL bits
+
+#define CTL_IEN			0x80
+#define CTL_ENAB		0x40
+#define CTL_STA			0x20
+#define CTL_STP			0x10
+#define CTL_IFLG		0x08
+#define CTL_AAK			0x04
+
+// I2C_SR status codes (master modes)
+
+#define SR_BUS_ERROR	0x00
+#define SR_START		0x08
+#define SR_RESTART		0x10
+#define SR_AW_ACK		0x18
+#define SR_AW_NACK		0x20
+#define SR_DW_ACK		0x28
+#define SR_DW_NACK		0x30
+#define SR_ARB_LOST		0x38
+#define SR_AR_ACK		0x40
+#define SR_AR_NACK		0x48
+#define SR_DR_ACK		0x50
+#define SR_DR_NACK		0x58
+
+// Poll limit for IFLG - about 10ms, well over one byte time at the slowest speed
+
+#define I2C_POLL_LIMIT	4000
+
+// Wait for the controller to finish the current step and return its status
+// - returns SR_BUS_ERROR if the controller never responds
+
+static uint8_t i2c_wait( void )
+{
+	uint24_t n;
+
+	for ( n = 0; n < I2C_POLL_LIMIT; n++ ) {
+		if ( port_in( I2C_CTL ) & CTL_IFLG ) return port_in( I2C_SR );
+	}
+	return SR_BUS_ERROR;
+}
+
+// Map a status code to a RET_* code
+
+static uint8_t i2c_error( uint8_t status )
+{
+	switch ( status ) {
+		case SR_AW_NACK:
+		case SR_AR_NACK:	return RET_NORESPONSE;
+		case SR_DW_NACK:	return RET_DATA_NACK;
+		case SR_ARB_LOST:	return RET_ARB_LOST;
+		default:			return RET_BUS_ERROR;
+	}
+}
+
+static void i2c_stop( void )
+{
+	uint24_t n;
+
+	port_out( I2C_CTL, CTL_ENAB | CTL_STP );
+	for ( n = 0; n < I2C_POLL_LIMIT && ( port_in( I2C_CTL ) & CTL_STP ); n++ );
+}
+
+void i2c_open( uint8_t speed )
+{
+	// SCL = 18.432MHz / (10 * (M + 1) * 2^N) with M = 7: N = 2, 1, 0 for 57600, 115200, 230400
+
+	if ( speed < I2C_SPEED_57600 || speed > I2C_SPEED_230400 ) speed = I2C_SPEED_57600;
+
+	port_out( I2C_SRR, 0 );								// Software reset
+	port_out( I2C_CCR, ( 7 << 3 ) | ( 3 - speed ) );
+	port_out( I2C_CTL, CTL_ENAB );
+}
+
+void i2c_close( void )
+{
+	port_out( I2C_CTL, 0 );
+}
+
+uint8_t i2c_transfer( const I2C_SEG *segs, uint8_t count )
+{
+	bool started = false;
+	uint8_t status;
+
+	for ( ; count; count--, segs++ ) {
+		uint8_t *p = segs->buf;
+		uint24_t len = segs->len;
+
+		if ( !started || !( segs->flags & I2C_SEG_NOSTART ) ) {
+			bool read = segs->flags & I2C_SEG_READ;
+
+			port_out( I2C_CTL, CTL_ENAB | CTL_STA );
+			status = i2c_wait();
+			if ( status != SR_START && status != SR_RESTART ) goto error;
+			started = true;
+
+			port_out( I2C_DR, ( segs->addr << 1 ) | read );
+			port_out( I2C_CTL, CTL_ENAB );
+			status = i2c_wait();
+			if ( status != ( read ? SR_AR_ACK : SR_AW_ACK ) ) goto error;
+		}
+
+		if ( segs->flags & I2C_SEG_READ ) {
+			// ACK every byte except the last so the device stops driving SDA
+
+			while ( len-- ) {
+				port_out( I2C_CTL, len ? CTL_ENAB | CTL_AAK : CTL_ENAB );
+				status = i2c_wait();
+				if ( status != SR_DR_ACK && status != SR_DR_NACK ) goto error;
+				*p++ = port_in( I2C_DR );
+			}
+		}
+		else {
+			while ( len-- ) {
+				port_out( I2C_DR, *p++ );
+				port_out( I2C_CTL, CTL_ENAB );
+				status = i2c_wait();
+				if ( status != SR_DW_ACK ) goto error;
+			}
+		}
+
+		if ( ( segs->flags & I2C_SEG_STOP ) && count > 1 ) {
+			i2c_stop();
+			started = false;
+		}
+	}
+
+	if ( started ) i2c_stop();
+	return RET_OK;
+
+error:
+	if ( status != SR_ARB_LOST ) i2c_stop();
+	else port_out( I2C_CTL, CTL_ENAB );					// Bus belongs to the other master
+	return i2c_error( status );
+}
+
+uint8_t i2c_read_regs( uint8_t addr, uint8_t reg, uint8_t *buf, uint24_t len )
+{
+	I2C_SEG segs[2] = {
+		{ addr, I2C_SEG_WRITE, 1, &reg },
+		{ addr, I2C_SEG_READ, len, buf }
+	};
+
+	return i2c_transfer( segs, 2 );
+}
+
+uint8_t i2c_write_regs( uint8_t addr, uint8_t reg, const uint8_t *buf, uint24_t len )
+{
+	I2C_SEG segs[2] = {
+		{ addr, I2C_SEG_WRITE, 1, &reg },
+		{ addr, I2C_SEG_WRITE | I2C_SEG_NOSTART, len, (uint8_t *)buf }
+	};
+
+	return i2c_transfer( segs, 2 );
+}
@@ -0,0 +1,265 @@
+#ifndef _CORO_HPP
+#define _CORO_HPP
+
+// Stackless scripts using C++20 coroutines (compile with CXXFLAGS += -std=c++20)
+//
+// - a function returning agon::Script can use co_await on the awaitables below, and is started
+//   with agon::spawn( script( args ) )
+// - the main loop calls agon::run_once() (e.g. once per frame), which resumes every script whose
+//   wait has finished - a waiting script costs one poll call per run_once()
+// - frames come from a fixed pool (CORO_FRAMES blocks of CORO_FRAME_SIZE bytes in BSS), not the
+//   heap - spawn() returns false if the frame does not fit or the pool is empty
+// - a finished script's frame goes back to the pool straight away
+// - unlike agon/task.h there is no stack per script, but only the script function itself can
+//   co_await (not the functions it calls)
+//
+// Define CORO_FRAME_SIZE / CORO_FRAMES before including this header to change the pool, in
+// every file that includes it.
+
+#include <coroutine>
+#include <stddef.h>
+#include <stdint.h>
+#include <mos_api.h>
+#include <intce.h>
+#include <vdp_vdu.h>
+
+#ifndef CORO_FRAME_SIZE
+#define CORO_FRAME_SIZE		128
+#endif
+#ifndef CORO_FRAMES
+#define CORO_FRAMES			16
+#endif
+
+namespace agon {
+
+// Fixed size block pool - bump allocates until every block has been used once, then reuses
+// freed blocks, so it needs no initialisation (it is zeroed with the rest of BSS)
+
+template <size_t SIZE, size_t COUNT>
+class FramePool {
+public:
+	void *alloc( size_t n ) {
+		Block *b;
+
+		if ( n > SIZE ) return nullptr;
+		if ( free_list ) {
+			b = free_list;
+			free_list = b->next;
+		}
+		else if ( used < COUNT ) b = &blocks[used++];
+		else return nullptr;
+		return b;
+	}
+
+	void free( void *p ) {
+		Block *b = static_cast<Block *>( p );
+
+		b->next = free_list;
+		free_list = b;
+	}
+
+private:
+	union Block {
+		Block *next;
+		unsigned char data[SIZE];
+	};
+
+	Block blocks[COUNT];
+	Block *free_list;
+	size_t used;
+};
+
+inline FramePool<CORO_FRAME_SIZE, CORO_FRAMES> coro_frames;
+
+class Script {
+public:
+	struct promise_type {
+		promise_type *next;				// run list
+		bool (*poll)( void *arg );		// wait condition (nullptr = ready)
+		void *poll_arg;
+
+		static void *operator new( size_t n ) noexcept { return coro_frames.alloc( n ); }
+		static void operator delete( void *p ) noexcept { coro_frames.free( p ); }
+		static Script get_return_object_on_allocation_failure() noexcept { return Script(); }
+
+		Script get_return_object() noexcept {
+			return Script( std::coroutine_handle<promise_type>::from_promise( *this ) );
+		}
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept {}
+
+		~promise_type() { unlink( this ); }
+	};
+
+	using Handle = std::coroutine_handle<promise_type>;
+
+	Script() : handle( nullptr ) {}
+	explicit Script( Handle h ) : handle( h ) {}
+	Script( Script &&s ) : handle( s.handle ) { s.handle = nullptr; }
+	Script( const Script & ) = delete;
+	Script &operator=( const Script & ) = delete;
+	~Script() { if ( handle ) handle.destroy(); }			// never spawned
+
+	explicit operator bool() const { return bool( handle ); }
+
+	// Hand the script to the scheduler - returns false if there was no frame for it
+
+	friend bool spawn( Script &&s ) {
+		promise_type *p;
+
+		if ( !s.handle ) return false;
+		p = &s.handle.promise();
+		s.handle = nullptr;
+		p->poll = nullptr;
+		p->next = run_list;
+		run_list = p;
+		count++;
+		return true;
+	}
+
+	// Resume every script that is ready, returns the number still running
+
+	friend int run_once() {
+		promise_type *p = run_list;
+
+		while ( p ) {
+			promise_type *next = p->next;		// p is freed if the script ends
+
+			if ( !p->poll || p->poll( p->poll_arg ) ) {
+				p->poll = nullptr;
+				Handle::from_promise( *p ).resume();
+			}
+			p = next;
+		}
+		return count;
+	}
+
+	friend int script_count() { return count; }
+
+private:
+	Handle handle;
+
+	static void unlink( promise_type *p ) {
+		promise_type **pp;
+
+		for ( pp = &run_list; *pp; pp = &( *pp )->next ) {
+			if ( *pp == p ) {
+				*pp = p->next;
+				count--;
+				return;
+			}
+		}
+	}
+
+	static inline promise_type *run_list;
+	static inline int count;
+};
+
+bool spawn( Script &&s );
+int run_once();
+int script_count();
+
+// Run until every script has finished
+
+inline void run() { while ( run_once() ); }
+
+// Awaitables
+// - each derived struct provides a static ready( void * ) that is polled by run_once()
+
+template <class T>
+struct Await {
+	bool await_ready() { return T::ready( this ); }
+	void await_suspend( Script::Handle h ) {
+		h.promise().poll = &T::ready;
+		h.promise().poll_arg = this;
+	}
+	void await_resume() {}
+};
+
+// Let the other scripts run once
+
+struct next_frame : Await<next_frame> {
+	bool first = true;
+
+	static bool ready( void *arg ) {
+		next_frame *a = static_cast<next_frame *>( arg );
+		bool r = !a->first;
+
+		a->first = false;
+		return r;
+	}
+};
+
+// Wait for ticks centiseconds of the sysvar clock
+
+struct sleep : Await<sleep> {
+	uint32_t wake;
+
+	explicit sleep( uint24_t ticks ) : wake( getsysvar_time() + ticks ) {}
+	static bool ready( void *arg ) {
+		return (int32_t)( getsysvar_time() - static_cast<sleep *>( arg )->wake ) >= 0;
+	}
+};
+
+// Wait for the next tick of the sysvar clock, which MOS advances in the vertical blanking interrupt
+
+struct vsync : Await<vsync> {
+	uint8_t last;
+
+	vsync() : last( (uint8_t)_agdev_sysvars->time ) {}
+	static bool ready( void *arg ) {
+		return (uint8_t)_agdev_sysvars->time != static_cast<vsync *>( arg )->last;
+	}
+};
+
+// Wait for the VDP to set one of the vdp_pflag_* bits in mask - the bits are cleared when the
+// awaitable is created, so create it before sending the command:
+//     auto reply = agon::vdp_reply( vdp_pflag_mode );
+//     vdp_get_scr_dims( false );
+//     co_await reply;
+
+struct vdp_reply : Await<vdp_reply> {
+	uint8_t mask;
+
+	explicit vdp_reply( uint8_t m ) : mask( m ) {
+		int_Disable();
+		_agdev_sysvars->vpd_pflags &= ~m;
+		int_Enable();
+	}
+	static bool ready( void *arg ) {
+		vdp_batch_flush();						// send the request if it's in a batch
+		return _agdev_sysvars->vpd_pflags & static_cast<vdp_reply *>( arg )->mask;
+	}
+};
+
+// Read len bytes from a MOS file handle, chunk bytes per run_once() so other scripts keep
+// running during a large load - co_await returns the number of bytes read
+
+struct read_chunks : Await<read_chunks> {
+	uint8_t fh;
+	char *buf;
+	size_t len;
+	size_t chunk;
+	size_t done;
+
+	read_chunks( uint8_t fh, void *buf, size_t len, size_t chunk = 512 )
+		: fh( fh ), buf( static_cast<char *>( buf ) ), len( len ), chunk( chunk ), done( 0 ) {}
+
+	static bool ready( void *arg ) {
+		read_chunks *a = static_cast<read_chunks *>( arg );
+		size_t n = a->len - a->done;
+		size_t got;
+
+		if ( n > a->chunk ) n = a->chunk;
+		got = mos_fread( a->fh, a->buf + a->done, n );
+		a->done += got;
+		return got < n || a->done == a->len;
+	}
+	size_t await_resume() { return done; }
+};
+
+} // namespace agon
+
+#endif
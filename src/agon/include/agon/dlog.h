@@ -0,0 +1,124 @@
+#ifndef _DLOG_H
+#define _DLOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Deferred format binary logging
+//
+// - DLOG( "x=%d y=%d", x, y ) records the address of the format string, the time and the raw
+//   argument values in a RAM ring - nothing is formatted and MOS isn't called, so it can be used
+//   in hot paths without changing their timing
+// - the ring is written to a file (or any sink, e.g. ser_write) a bit at a time by dlog_poll(),
+//   or all at once by dlog_flush(), which is also called on exit
+// - tools/agon/dlog.py reads the log with the program's .bin (and optionally .map) and prints
+//   the text, formatting it as printf would
+// - format strings must be string literals (or other constant strings in the program image)
+// - up to DLOG_MAX_ARGS arguments: integers up to 32 bits, float / double, and char * / void *
+//   (cast other pointers to void *; %s of a string outside the program image, e.g. on the heap,
+//   shows as its address)
+// - if the ring is full the record is dropped, and a count of the dropped records is logged
+// - not for use in interrupt handlers
+//
+// Log format (little endian):
+//     "AGDL"
+//     uint8_t  version (1)
+//     uint24_t address of DLOG_MARKER in the program (to find where the .bin is loaded)
+//     records * {
+//         uint24_t format string address (0 for "records dropped", one uint32_t argument)
+//         uint24_t time (centiseconds, sysvar time)
+//         uint8_t  argument count
+//         uint8_t  argument types, 2 bits each from bit 0 (DLOG_INT ...)
+//         arguments - 3 bytes for DLOG_INT and DLOG_PTR, 4 for DLOG_LONG and DLOG_FLOAT
+//     }
+
+#define DLOG_MAX_ARGS		4
+#define DLOG_MARKER			"AGDL string table"
+
+enum { DLOG_INT, DLOG_LONG, DLOG_FLOAT, DLOG_PTR };
+
+// Output for the log - returns the number of bytes taken, which may be less than len
+typedef int (*DLOG_SINK)( const void *buf, int len );
+
+// Use size bytes at buf for the ring - size is rounded down to a power of 2
+bool dlog_init( void *buf, uint24_t size );
+
+// Send the log to a new file / to sink - writes the log header, and flushes on exit
+bool dlog_open( const char *fname );
+void dlog_open_sink( DLOG_SINK sink );
+
+// Write up to max bytes of the ring (e.g. once a frame), returns the bytes written
+uint24_t dlog_poll( uint24_t max );
+
+// Write everything in the ring
+void dlog_flush( void );
+
+// Flush and close the file
+void dlog_close( void );
+
+// Bytes waiting in the ring, and records dropped since dlog_init()
+uint24_t dlog_pending( void );
+uint24_t dlog_dropped( void );
+
+// Called by DLOG() - desc is the argument count | types << 8, then one uint32_t per argument
+void dlog_record( const char *fmt, uint24_t desc, ... );
+
+static inline uint32_t _dlog_ibits( uint32_t x ) { return x; }
+static inline uint32_t _dlog_pbits( const void *p ) { return (uint24_t)p; }
+static inline uint32_t _dlog_fbits( float f ) { union { float f; uint32_t u; } v; v.f = f; return v.u; }
+
+#ifdef __cplusplus
+}
+
+static inline uint8_t _dlog_type( long ) { return DLOG_LONG; }
+static inline uint8_t _dlog_type( unsigned long ) { return DLOG_LONG; }
+static inline uint8_t _dlog_type( long long ) { return DLOG_LONG; }
+static inline uint8_t _dlog_type( unsigned long long ) { return DLOG_LONG; }
+static inline uint8_t _dlog_type( float ) { return DLOG_FLOAT; }
+static inline uint8_t _dlog_type( double ) { return DLOG_FLOAT; }
+template <typename T> static inline uint8_t _dlog_type( T * ) { return DLOG_PTR; }
+template <typename T> static inline uint8_t _dlog_type( T ) { return DLOG_INT; }
+
+static inline uint32_t _dlog_bits( float f ) { return _dlog_fbits( f ); }
+static inline uint32_t _dlog_bits( double f ) { return _dlog_fbits( f ); }
+template <typename T> static inline uint32_t _dlog_bits( T *p ) { return _dlog_pbits( p ); }
+template <typename T> static inline uint32_t _dlog_bits( T x ) { return _dlog_ibits( x ); }
+
+#define _DLOG_TYPE(x)	_dlog_type( x )
+#define _DLOG_BITS(x)	_dlog_bits( x )
+#else
+#define _DLOG_TYPE(x)	_Generic( (x), \
+	long: DLOG_LONG, unsigned long: DLOG_LONG, long long: DLOG_LONG, unsigned long long: DLOG_LONG, \
+	float: DLOG_FLOAT, double: DLOG_FLOAT, long double: DLOG_FLOAT, \
+	char *: DLOG_PTR, const char *: DLOG_PTR, void *: DLOG_PTR, const void *: DLOG_PTR, \
+	default: DLOG_INT )
+#define _DLOG_BITS(x)	_Generic( (x), \
+	float: _dlog_fbits, double: _dlog_fbits, long double: _dlog_fbits, \
+	char *: _dlog_pbits, const char *: _dlog_pbits, void *: _dlog_pbits, const void *: _dlog_pbits, \
+	default: _dlog_ibits )( x )
+#endif
+
+// The types are constant, so desc is worked out by the compiler
+
+#define _DLOG_N(...)				_DLOG_N_( __VA_ARGS__, 4, 3, 2, 1, 0 )
+#define _DLOG_N_(f, a, b, c, d, n, ...)	n
+#define _DLOG_CAT(a, b)				_DLOG_CAT_( a, b )
+#define _DLOG_CAT_(a, b)			a##b
+
+#define _DLOG0(f)				dlog_record( f, 0 )
+#define _DLOG1(f, a)			dlog_record( f, 1 | _DLOG_TYPE( a ) << 8, _DLOG_BITS( a ) )
+#define _DLOG2(f, a, b)			dlog_record( f, 2 | ( _DLOG_TYPE( a ) | _DLOG_TYPE( b ) << 2 ) << 8, \
+									_DLOG_BITS( a ), _DLOG_BITS( b ) )
+#define _DLOG3(f, a, b, c)		dlog_record( f, 3 | ( _DLOG_TYPE( a ) | _DLOG_TYPE( b ) << 2 | _DLOG_TYPE( c ) << 4 ) << 8, \
+									_DLOG_BITS( a ), _DLOG_BITS( b ), _DLOG_BITS( c ) )
+#define _DLOG4(f, a, b, c, d)	dlog_record( f, 4 | ( _DLOG_TYPE( a ) | _DLOG_TYPE( b ) << 2 | _DLOG_TYPE( c ) << 4 | _DLOG_TYPE( d ) << 6 ) << 8, \
+									_DLOG_BITS( a ), _DLOG_BITS( b ), _DLOG_BITS( c ), _DLOG_BITS( d ) )
+
+#define DLOG(...)				_DLOG_CAT( _DLOG, _DLOG_N( __VA_ARGS__ ) )( __VA_ARGS__ )
+
+#endif
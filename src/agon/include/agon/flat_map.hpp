@@ -0,0 +1,91 @@
+#ifndef _FLAT_MAP_HPP
+#define _FLAT_MAP_HPP
+
+// flat_map<K, V, N> - a map kept as a sorted array of up to N entries (no heap)
+//
+// - lookups are a binary search, inserts and erases move the later entries (fine for the tens
+//   of entries typical on the Agon, and much more compact than a tree or hash table)
+// - K needs operator< ; iteration is in key order
+
+#include <agon/static_vector.hpp>
+
+namespace agon {
+
+template <class K, class V, size_t N>
+class flat_map {
+public:
+	struct value_type {
+		K key;
+		V value;
+	};
+
+	using size_type = index_for<N>;
+	using iterator = value_type *;
+	using const_iterator = const value_type *;
+
+	size_type size() const { return entries.size(); }
+	static constexpr size_type capacity() { return N; }
+	bool empty() const { return entries.empty(); }
+	bool full() const { return entries.full(); }
+	void clear() { entries.clear(); }
+
+	iterator begin() { return entries.begin(); }
+	iterator end() { return entries.end(); }
+	const_iterator begin() const { return entries.begin(); }
+	const_iterator end() const { return entries.end(); }
+
+	// Value for key, or nullptr if not present
+
+	V *find( const K &key ) {
+		size_type i = lower_bound( key );
+
+		return i < entries.size() && !( key < entries[i].key ) ? &entries[i].value : nullptr;
+	}
+
+	const V *find( const K &key ) const { return const_cast<flat_map *>( this )->find( key ); }
+
+	bool contains( const K &key ) const { return find( key ) != nullptr; }
+
+	// Add or replace - returns false if the key is new and the map is full
+
+	bool insert( const K &key, const V &value ) {
+		size_type i = lower_bound( key );
+
+		if ( i < entries.size() && !( key < entries[i].key ) ) {
+			entries[i].value = value;
+			return true;
+		}
+		return entries.insert( i, value_type{ key, value } );
+	}
+
+	bool erase( const K &key ) {
+		size_type i = lower_bound( key );
+
+		if ( i < entries.size() && !( key < entries[i].key ) ) {
+			entries.erase( i );
+			return true;
+		}
+		return false;
+	}
+
+private:
+	// Index of the first entry not less than key
+
+	size_type lower_bound( const K &key ) const {
+		size_type lo = 0, hi = entries.size();
+
+		while ( lo < hi ) {
+			size_type mid = lo + ( hi - lo ) / 2;
+
+			if ( entries[mid].key < key ) lo = mid + 1;
+			else hi = mid;
+		}
+		return lo;
+	}
+
+	static_vector<value_type, N> entries;
+};
+
+} // namespace agon
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef _I2C_H
+#define _I2C_H
+
+#include <stdint.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Batched I2C transactions driving the eZ80 I2C controller directly
+//
+// - mos_i2c_write / mos_i2c_read transfer at most 255 bytes to one device per MOS call
+// - i2c_transfer() runs a list of read / write segments (to any number of devices) in one call,
+//   using a repeated START between segments and a single STOP at the end
+// - the controller is polled, so the MOS I2C interrupt handler is not used
+// - return values are the RET_* codes from mos_api.h
+
+// Segment flags
+
+#define I2C_SEG_WRITE		0x00
+#define I2C_SEG_READ		0x01
+#define I2C_SEG_NOSTART		0x02		// continue the previous write without a repeated START
+#define I2C_SEG_STOP		0x04		// send STOP after this segment (always done after the last)
+
+typedef struct {
+	uint8_t addr;						// 7-bit device address
+	uint8_t flags;						// I2C_SEG_*
+	uint24_t len;						// bytes to transfer (may be more than 255)
+	uint8_t *buf;
+} I2C_SEG;
+
+// Set up the controller - speed is I2C_SPEED_57600, I2C_SPEED_115200 or I2C_SPEED_230400
+void i2c_open( uint8_t speed );
+void i2c_close( void );
+
+// Run count segments, returns RET_OK or the error from the segment that failed
+// - on error a STOP is sent and the remaining segments are skipped
+uint8_t i2c_transfer( const I2C_SEG *segs, uint8_t count );
+
+// Register burst helpers for the usual "write register pointer, then data" devices
+uint8_t i2c_read_regs( uint8_t addr, uint8_t reg, uint8_t *buf, uint24_t len );
+uint8_t i2c_write_regs( uint8_t addr, uint8_t reg, const uint8_t *buf, uint24_t len );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
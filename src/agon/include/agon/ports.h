@@ -0,0 +1,88 @@
+#ifndef _PORTS_H
+#define _PORTS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// eZ80F92 on-chip peripheral port access
+
+uint8_t port_in( uint16_t port );
+void port_out( uint16_t port, uint8_t value );
+
+// Port D - UART1 uses PD0 (TxD1), PD1 (RxD1), PD2 (RTS1) and PD3 (CTS1)
+
+#define PD_DR			0xA2
+#define PD_DDR			0xA3
+#define PD_ALT1			0xA4
+#define PD_ALT2			0xA5
+
+// UART1 - registers at 0xD0 and 0xD1 are the baud rate generator while LCTL_DLAB is set
+
+#define UART1_RBR		0xD0
+#define UART1_THR		0xD0
+#define UART1_BRG_L		0xD0
+#define UART1_BRG_H		0xD1
+#define UART1_IER		0xD1
+#define UART1_IIR		0xD2
+#define UART1_FCTL		0xD2
+#define UART1_LCTL		0xD3
+#define UART1_MCTL		0xD4
+#define UART1_LSR		0xD5
+#define UART1_MSR		0xD6
+#define UART1_SPR		0xD7
+
+#define UART_IER_RIE	0x01
+#define UART_IER_TIE	0x02
+#define UART_IER_LSIE	0x04
+#define UART_IER_MIIE	0x08
+
+#define UART_FCTL_FIFOEN	0x01
+#define UART_FCTL_CLRRXF	0x02
+#define UART_FCTL_CLRTXF	0x04
+#define UART_FCTL_TRIG_8	0x80
+
+#define UART_LCTL_5BITS	0x00
+#define UART_LCTL_STOP2	0x04
+#define UART_LCTL_PEN	0x08
+#define UART_LCTL_EPS	0x10
+#define UART_LCTL_DLAB	0x80
+
+#define UART_MCTL_DTR	0x01
+#define UART_MCTL_RTS	0x02
+
+#define UART_LSR_DR		0x01
+#define UART_LSR_OE		0x02
+#define UART_LSR_THRE	0x20
+#define UART_LSR_TEMT	0x40
+
+#define UART_MSR_CTS	0x10
+
+// I2C controller
+
+#define I2C_SAR			0xC8
+#define I2C_XSAR		0xC9
+#define I2C_DR			0xCA
+#define I2C_CTL			0xCB
+#define I2C_SR			0xCC
+#define I2C_CCR			0xCC
+#define I2C_SRR			0xCD
+
+// Interrupt vectors (for mos_setintvector)
+
+#define UART0_IVECT		0x18
+#define UART1_IVECT		0x1A
+#define I2C_IVECT		0x1C
+#define PORTB1_IVECT	0x32
+
+// System clock
+
+#define EZ80_SYS_CLOCK	18432000L
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef _RING_BUFFER_HPP
+#define _RING_BUFFER_HPP
+
+// ring_buffer<T, N> - single producer / single consumer queue with no locking
+//
+// - safe with the producer in an interrupt handler and the consumer in the main program (or
+//   the other way round): the producer only writes head and the consumer only writes tail
+// - N must be a power of 2 no larger than 128: the indices are free running single bytes, which
+//   the eZ80 reads and writes in one instruction, and head - tail (0 to N) is the fill level
+// - T should be a small trivially copyable type (bytes, events, key codes)
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace agon {
+
+template <class T, size_t N>
+class ring_buffer {
+	static_assert( N >= 2 && N <= 128 && ( N & ( N - 1 ) ) == 0, "N must be a power of 2 up to 128" );
+
+public:
+	ring_buffer() : head( 0 ), tail( 0 ) {}
+
+	// Producer side
+
+	bool push( const T &x ) {
+		uint8_t h = head;
+
+		if ( (uint8_t)( h - tail ) == N ) return false;
+		buf[h & ( N - 1 )] = x;
+		barrier();								// data must be written before head moves
+		head = h + 1;
+		return true;
+	}
+
+	size_t free() const { return N - size(); }
+
+	// Consumer side
+
+	bool pop( T &x ) {
+		uint8_t t = tail;
+
+		if ( t == head ) return false;
+		x = buf[t & ( N - 1 )];
+		barrier();								// data must be read before tail moves
+		tail = t + 1;
+		return true;
+	}
+
+	// Oldest element, only valid if !empty()
+	const T &peek() const { return buf[tail & ( N - 1 )]; }
+
+	// Either side
+
+	size_t size() const { return (uint8_t)( head - tail ); }
+	bool empty() const { return head == tail; }
+	bool full() const { return size() == N; }
+	static constexpr size_t capacity() { return N; }
+
+	// Only call from the consumer (or with the producer stopped)
+	void clear() { tail = head; }
+
+private:
+	static void barrier() { asm volatile( "" ::: "memory" ); }
+
+	T buf[N];
+	volatile uint8_t head;
+	volatile uint8_t tail;
+};
+
+} // namespace agon
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef _SERIAL_H
+#define _SERIAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Interrupt driven UART1 driver
+//
+// - replaces mos_uopen / mos_ugetc / mos_uputc, which make one MOS call per byte and
+//   lose data at higher baud rates when the main loop is busy
+// - RX and TX are buffered in 256 byte rings serviced by an ISR on vector 0x1A
+// - ser_read / ser_write never block; they return the number of bytes actually transferred
+// - set UART.flowcontrol non-zero to use RTS/CTS (PD2/PD3)
+
+#define SER_BUFFER_SIZE		256
+
+// Open UART1 with the given settings (baudRate, dataBits, stopBits, parity, flowcontrol)
+// - parity: 0 = none, 1 = odd, 3 = even
+// - returns 0 on success, -1 if already open or the settings are invalid
+int ser_open( const UART *settings );
+
+// Wait (up to 1 second) for pending output then disable UART1 and restore the interrupt vector
+// - also called automatically on exit
+void ser_close( void );
+
+// Non-blocking block transfers
+int ser_read( void *buf, int len );
+int ser_write( const void *buf, int len );
+
+// Single byte read, returns -1 if no data is waiting
+int ser_getc( void );
+
+// Bytes waiting in the RX ring / space free in the TX ring
+int ser_available( void );
+int ser_tx_free( void );
+
+// Wait until the TX ring and FIFO are empty
+// - timeout in centiseconds (0 = wait forever), returns false on timeout
+bool ser_drain( uint24_t timeout );
+
+// Number of bytes lost to FIFO overruns or a full RX ring since the last call
+uint8_t ser_errors( void );
+
+// Return a FILE* for use with stdio (fprintf, fgets, fwrite etc)
+// - reads through the FILE* block until a byte arrives
+// - use "b" in the mode for binary, otherwise "\n" is sent as "\r\n"
+FILE *ser_fopen( const char *mode );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
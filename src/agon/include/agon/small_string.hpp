@@ -0,0 +1,111 @@
+#ifndef _SMALL_STRING_HPP
+#define _SMALL_STRING_HPP
+
+// small_string<N> - a string of up to N characters stored inside the object (no heap)
+//
+// - always NUL terminated, so c_str() can be passed straight to the C library
+// - appends that don't fit are truncated and return false
+// - N is at most 255, so the length is a single byte
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace agon {
+
+template <size_t N>
+class small_string {
+	static_assert( N > 0 && N < 256, "N must be 1 to 255" );
+
+public:
+	small_string() : len( 0 ) { buf[0] = '\0'; }
+	small_string( const char *s ) : len( 0 ) { buf[0] = '\0'; append( s ); }
+
+	small_string &operator=( const char *s ) {
+		clear();
+		append( s );
+		return *this;
+	}
+
+	const char *c_str() const { return buf; }
+	char *data() { return buf; }
+	uint8_t size() const { return len; }
+	uint8_t length() const { return len; }
+	static constexpr uint8_t capacity() { return N; }
+	bool empty() const { return len == 0; }
+
+	char &operator[]( uint8_t i ) { return buf[i]; }
+	char operator[]( uint8_t i ) const { return buf[i]; }
+
+	const char *begin() const { return buf; }
+	const char *end() const { return buf + len; }
+
+	void clear() {
+		len = 0;
+		buf[0] = '\0';
+	}
+
+	bool append( const char *s, size_t n ) {
+		bool fits = n <= (size_t)( N - len );
+
+		if ( !fits ) n = N - len;
+		memcpy( buf + len, s, n );
+		len += n;
+		buf[len] = '\0';
+		return fits;
+	}
+
+	bool append( const char *s ) { return append( s, strlen( s ) ); }
+
+	bool append( char c ) {
+		if ( len == N ) return false;
+		buf[len++] = c;
+		buf[len] = '\0';
+		return true;
+	}
+
+	// Decimal integer
+	bool append( int v ) {
+		char tmp[9];
+		uint8_t i = sizeof( tmp );
+		unsigned int u = v < 0 ? -(unsigned int)v : v;
+
+		do {
+			tmp[--i] = '0' + u % 10;
+			u /= 10;
+		} while ( u );
+		if ( v < 0 ) tmp[--i] = '-';
+		return append( tmp + i, sizeof( tmp ) - i );
+	}
+
+	template <class T>
+	small_string &operator+=( T x ) {
+		append( x );
+		return *this;
+	}
+
+	// Shorten to n characters (no effect if already shorter)
+	void truncate( uint8_t n ) {
+		if ( n < len ) {
+			len = n;
+			buf[len] = '\0';
+		}
+	}
+
+	bool operator==( const char *s ) const { return strcmp( buf, s ) == 0; }
+	bool operator!=( const char *s ) const { return strcmp( buf, s ) != 0; }
+	template <size_t M>
+	bool operator==( const small_string<M> &s ) const { return len == s.size() && memcmp( buf, s.c_str(), len ) == 0; }
+	template <size_t M>
+	bool operator!=( const small_string<M> &s ) const { return !( *this == s ); }
+	template <size_t M>
+	bool operator<( const small_string<M> &s ) const { return strcmp( buf, s.c_str() ) < 0; }
+
+private:
+	char buf[N + 1];
+	uint8_t len;
+};
+
+} // namespace agon
+
+#endif
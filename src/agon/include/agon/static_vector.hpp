@@ -0,0 +1,133 @@
+#ifndef _STATIC_VECTOR_HPP
+#define _STATIC_VECTOR_HPP
+
+// static_vector<T, N> - a vector with its storage inside the object (no heap)
+//
+// - size is kept in a uint8_t when N < 256, otherwise a uint24_t
+// - operations that would exceed the capacity return false (there are no exceptions)
+// - erase_unordered() moves the last element into the gap, O(1) where the order doesn't matter
+//   (e.g. a list of active sprites)
+
+#include <stddef.h>
+#include <stdint.h>
+#if __has_include(<new>)
+#include <new>
+#else
+inline void *operator new( size_t, void *p ) noexcept { return p; }
+#endif
+
+namespace agon {
+
+// Smallest native index type for a capacity
+
+template <bool SMALL> struct index_type { using type = uint24_t; };
+template <> struct index_type<true> { using type = uint8_t; };
+template <size_t N> using index_for = typename index_type<( N < 256 )>::type;
+
+template <class T, size_t N>
+class static_vector {
+public:
+	using value_type = T;
+	using size_type = index_for<N>;
+	using iterator = T *;
+	using const_iterator = const T *;
+
+	static_vector() : count( 0 ) {}
+	~static_vector() { clear(); }
+
+	static_vector( const static_vector &v ) : count( 0 ) {
+		for ( const T &x : v ) push_back( x );
+	}
+
+	static_vector &operator=( const static_vector &v ) {
+		if ( this != &v ) {
+			clear();
+			for ( const T &x : v ) push_back( x );
+		}
+		return *this;
+	}
+
+	// Capacity
+
+	size_type size() const { return count; }
+	static constexpr size_type capacity() { return N; }
+	bool empty() const { return count == 0; }
+	bool full() const { return count == N; }
+
+	// Element access - no bounds checks
+
+	T &operator[]( size_type i ) { return data()[i]; }
+	const T &operator[]( size_type i ) const { return data()[i]; }
+	T &front() { return data()[0]; }
+	T &back() { return data()[count - 1]; }
+	const T &front() const { return data()[0]; }
+	const T &back() const { return data()[count - 1]; }
+
+	T *data() { return reinterpret_cast<T *>( storage ); }
+	const T *data() const { return reinterpret_cast<const T *>( storage ); }
+
+	iterator begin() { return data(); }
+	iterator end() { return data() + count; }
+	const_iterator begin() const { return data(); }
+	const_iterator end() const { return data() + count; }
+
+	// Modifiers
+
+	bool push_back( const T &x ) {
+		if ( full() ) return false;
+		new ( data() + count ) T( x );
+		count++;
+		return true;
+	}
+
+	template <class... A>
+	T *emplace_back( A &&... args ) {
+		T *p;
+
+		if ( full() ) return nullptr;
+		p = new ( data() + count ) T( static_cast<A &&>( args )... );
+		count++;
+		return p;
+	}
+
+	void pop_back() {
+		if ( count ) data()[--count].~T();
+	}
+
+	// Insert before position i, shifting the later elements up
+	bool insert( size_type i, const T &x ) {
+		if ( full() || i > count ) return false;
+		if ( i == count ) return push_back( x );
+		new ( data() + count ) T( static_cast<T &&>( data()[count - 1] ) );
+		for ( size_type j = count - 1; j > i; j-- ) data()[j] = static_cast<T &&>( data()[j - 1] );
+		data()[i] = x;
+		count++;
+		return true;
+	}
+
+	// Remove element i, shifting the later elements down
+	void erase( size_type i ) {
+		if ( i >= count ) return;
+		for ( size_type j = i + 1; j < count; j++ ) data()[j - 1] = static_cast<T &&>( data()[j] );
+		pop_back();
+	}
+
+	// Remove element i by moving the last element into its place
+	void erase_unordered( size_type i ) {
+		if ( i >= count ) return;
+		if ( i != count - 1 ) data()[i] = static_cast<T &&>( data()[count - 1] );
+		pop_back();
+	}
+
+	void clear() {
+		while ( count ) data()[--count].~T();
+	}
+
+private:
+	alignas( T ) unsigned char storage[N * sizeof( T )];
+	size_type count;
+};
+
+} // namespace agon
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef _TASK_H
+#define _TASK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cooperative tasks (green threads)
+//
+// - each task runs on its own stack allocated from the heap, and only gives up the CPU in
+//   task_yield(), task_sleep_ticks() or one of the task_wait_*() calls
+// - a waiting task is resumed by whichever task next yields, so waits on the VDP (through the
+//   sysvar flags), timers or I/O overlap with useful work in the other tasks
+// - main() is task 0 and is always present
+// - task switching is done with setjmp / longjmp, so only IX, SP and the return address are
+//   saved - the same registers the compiler expects a call to preserve
+
+#define TASK_STACK_DEFAULT	1024		// bytes, used if stack_size is 0
+#define TASK_STACK_MIN		256
+
+typedef void (*TASK_FN)( void *arg );
+
+// Start fn( arg ) as a new task - it first runs at the next yield
+// - returns the task id (> 0), or -1 if the stack could not be allocated
+// - the task ends when fn returns or it calls task_exit()
+int task_spawn( TASK_FN fn, void *arg, size_t stack_size );
+
+// Let the other ready tasks run, returns when this task is next scheduled
+void task_yield( void );
+
+// Yield for at least ticks centiseconds (sysvar clock, updated in the vertical blanking interrupt)
+void task_sleep_ticks( uint24_t ticks );
+
+// Yield until (*flag & mask) != 0 - the flag is typically set by an interrupt or another task
+void task_wait_flag( volatile uint8_t *flag, uint8_t mask );
+
+// Yield until cond( arg ) returns true - e.g. task_wait_until( ser_has_data, NULL )
+void task_wait_until( bool (*cond)( void *arg ), void *arg );
+
+// Yield until the VDP sets one of the vdp_pflag_* bits in mask (sysvar vpd_pflags)
+// - clear the bits with task_vdp_request() before sending the command that sets them
+void task_vdp_request( uint8_t mask );
+void task_wait_vdp( uint8_t mask );
+
+// End the current task (in task 0 this is the same as exit(0))
+void task_exit( void ) __attribute__((noreturn));
+
+// Id of the current task, whether a task is still running, and the number of tasks
+int task_id( void );
+bool task_alive( int id );
+int task_count( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
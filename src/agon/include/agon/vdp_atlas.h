@@ -0,0 +1,46 @@
+#ifndef _VDP_ATLAS_H
+#define _VDP_ATLAS_H
+
+#include <stdint.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sprite sheet atlases - all the frames of a sprite in one file and one transfer
+//
+// - the file (made by tools/agon/mkatlas.py) holds equal sized frames one above the other, so
+//   each frame is a contiguous run of bytes
+// - the whole image is sent to a temporary buffer in one write, split on the VDP into one buffer
+//   per frame (buffer split command 17), and each buffer is made into a bitmap
+// - bitmap IDs are buffer IDs: use 0xFA00 + n for the 8-bit bitmap numbers used by
+//   vdp_select_bitmap / vdp_add_sprite_bitmap
+//
+// File format (little endian):
+//     "AGAT"
+//     uint8_t  version (1)
+//     uint8_t  format              0 = RGBA8888, 1 = RGBA2222 (as vdp_adv_bitmap_from_buffer)
+//     uint16_t frame width, frame height, frame count
+//     frames * height * width pixels
+
+#define VDP_ATLAS_RGBA8888	0
+#define VDP_ATLAS_RGBA2222	1
+
+typedef struct {
+	uint16_t width;						// of each frame
+	uint16_t height;
+	uint16_t frames;
+	uint8_t format;
+} VDP_ATLAS;
+
+// Load an atlas into bitmaps first_id, first_id + 1, ... using temp_id as the upload buffer
+// - returns the number of frames, or -1 if the file can't be read or a frame is over 64KB
+// - info (may be NULL) is filled in from the header
+int vdp_atlas_load( const char *fname, int first_id, int temp_id, VDP_ATLAS *info );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
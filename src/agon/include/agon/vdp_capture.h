@@ -0,0 +1,68 @@
+#ifndef _VDP_CAPTURE_H
+#define _VDP_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// VDU stream capture - what the program sends to the VDP, by command and by frame
+//
+// - while capturing, everything written with vdp_write (all the vdp_* functions) and outchar
+//   (putchar / printf to the console) is parsed into VDU commands as it's sent
+// - each command is counted against a key of its first bytes: the VDU code, plus for VDU 23 the
+//   next byte, and for VDU 23, 0 and VDU 23, 27 the one after (e.g. 23,27,13 sprite move). All
+//   printable characters share the key 32. Data following a command (bitmap pixels, buffer
+//   blocks) is counted with the command
+// - vdp_capture_frame() ends a frame: its bytes and commands are added to the timeline
+// - optionally the raw bytes are kept as well, for tools/agon/vducap.py to decode in full
+// - output sent with putch or mos_puts directly isn't seen
+//
+// Dump file format (little endian):
+//     "AGVC"
+//     uint8_t  version (1)
+//     uint16_t keys,    keys * { uint24_t key, uint32_t commands, uint32_t bytes }
+//     uint24_t frames,  frames * { uint24_t bytes, uint16_t commands }
+//     uint32_t total bytes
+//     uint24_t raw,     raw bytes as sent (the first raw bytes of the total)
+
+#define VDP_CAPTURE_KEYS	48			// distinct command keys counted
+
+typedef struct {
+	uint24_t key;						// code | next << 8 | next << 16
+	uint32_t commands;
+	uint32_t bytes;
+} VDP_CAPTURE_KEY;
+
+typedef struct {
+	uint24_t bytes;
+	uint16_t commands;
+} VDP_CAPTURE_FRAME;
+
+// Start capturing (clears previous counts) - frames (max_frames entries) and raw (raw_size
+// bytes) may be NULL / 0 to not keep the timeline / the raw stream
+void vdp_capture_start( VDP_CAPTURE_FRAME *frames, int max_frames, uint8_t *raw, uint24_t raw_size );
+void vdp_capture_stop( void );
+
+// End the current frame
+void vdp_capture_frame( void );
+
+// Results so far - returns the number of keys / frames, total is the bytes captured
+int vdp_capture_keys( const VDP_CAPTURE_KEY **keys );
+int vdp_capture_frames( void );
+uint32_t vdp_capture_total( void );
+
+// Print the keys by bytes sent (stops capturing while printing)
+void vdp_capture_print( void );
+
+// Write everything to a file for vducap.py, returns 0 or -1
+int vdp_capture_dump( const char *fname );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
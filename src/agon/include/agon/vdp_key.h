@@ -30,6 +30,39 @@ void vdp_update_key_state();
 bool vdp_check_key_press( uint8_t key_code );
 void vdp_set_key_event_handler( KEY_EVENT_HANDLER event_handler );
 
+// Keypadc style keyboard snapshot
+// - kb_Scan() copies vdp_key_bits once per frame and works out which keys changed
+// - the kb_Is* macros reduce to a single load and bit test when the key code is a constant
+
+extern uint8_t kb_Data[32];
+extern uint8_t kb_Pressed[32];
+extern uint8_t kb_Released[32];
+
+void kb_Scan( void );
+void kb_Reset( void );
+
+#define KB_BYTE( code ) ( (uint8_t)(code) >> 3 )
+#define KB_BIT( code ) ( 1 << ((code) & 0x07) )
+
+#define kb_IsDown( code ) ( kb_Data[KB_BYTE( code )] & KB_BIT( code ) )
+#define kb_IsPressed( code ) ( kb_Pressed[KB_BYTE( code )] & KB_BIT( code ) )
+#define kb_IsReleased( code ) ( kb_Released[KB_BYTE( code )] & KB_BIT( code ) )
+
+// Key codes as stored in vdp_key_bits
+// - KB_KEY_LETTER( c ) is the unshifted letter's code (VK_a - VK_z) for either case of c. With
+//   shift the VDP reports a different code (VK_A - VK_Z), which kb_Scan() adds to the unshifted
+//   one, so the kb_Is* macros see a letter whatever the shift state. vdp_check_key_press() and
+//   vdp_key_bits don't
+
+#define KB_KEY_SPACE			0x01
+#define KB_KEY_DIGIT( d )		( 0x02 + (d) - '0' )
+#define KB_KEY_LETTER( c )		( 0x16 + ((c) | 0x20) - 'a' )
+#define KB_KEY_ESCAPE			0x7D
+#define KB_KEY_UP				0x96
+#define KB_KEY_DOWN				0x98
+#define KB_KEY_LEFT				0x9A
+#define KB_KEY_RIGHT			0x9C
+
 #ifdef __cplusplus
 }
 #endif
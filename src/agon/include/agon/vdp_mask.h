@@ -0,0 +1,61 @@
+#ifndef _VDP_MASK_H
+#define _VDP_MASK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 1-bit collision masks for pixel accurate sprite collisions without reading back from the VDP
+//
+// - a mask holds one bit per pixel, set where the pixel's alpha is at least VDP_MASK_ALPHA,
+//   packed 8 pixels to a byte with the leftmost pixel in bit 7
+// - masks are built from the RGBA data as the bitmap loaders send it (vdp_mask_capture), from
+//   pixels in RAM (vdp_mask_from_rgba), or loaded from a file made by mkatlas.py --mask
+// - the functions that build masks don't free what was in them, so a VDP_MASK can start out
+//   uninitialised - vdp_mask_free() one before building into it again
+// - vdp_mask_overlap() is a bounding box test, and only if the boxes overlap, an AND of the
+//   overlapping rows with one mask shifted to the other's alignment (vdp_mask_span.src)
+//
+// Mask file format (little endian):
+//     "AGMK"
+//     uint8_t  version (1), reserved (0)
+//     uint16_t frame width, frame height, frame count
+//     frames * height * ((width + 7) / 8) bytes
+
+#define VDP_MASK_ALPHA		0x80
+#define VDP_MASK_MAX_WIDTH	2040			// stride is 8-bit
+
+typedef struct {
+	uint16_t width;
+	uint16_t height;
+	uint8_t stride;						// bytes per row
+	uint8_t *bits;						// height * stride bytes, NULL if not allocated
+} VDP_MASK;
+
+// Allocate a clear mask, returns 0, or -1 if out of memory or the width isn't 1 - VDP_MASK_MAX_WIDTH
+// or the height 1 - 65535
+int vdp_mask_alloc( VDP_MASK *m, int width, int height );
+void vdp_mask_free( VDP_MASK *m );
+
+// Build a mask from width * height RGBA8888 pixels, returns 0 or -1 if out of memory
+int vdp_mask_from_rgba( VDP_MASK *m, const uint32_t *pixels, int width, int height );
+
+// Build masks for the bitmaps sent by the next vdp_load_bitmap_file() or
+// vdp_load_sprite_bitmaps() call - one per bitmap, up to count, into masks[]
+// - masks[] is cleared first, so masks that aren't loaded or can't be allocated have bits == NULL
+void vdp_mask_capture( VDP_MASK *masks, int count );
+
+// Load up to max masks from a mask file, returns the number loaded or -1
+int vdp_mask_load( const char *fname, VDP_MASK *masks, int max );
+
+// True if any set pixel of a drawn at (ax, ay) is over a set pixel of b drawn at (bx, by)
+bool vdp_mask_overlap( const VDP_MASK *a, int ax, int ay, const VDP_MASK *b, int bx, int by );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
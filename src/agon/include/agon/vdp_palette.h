@@ -0,0 +1,53 @@
+#ifndef _VDP_PALETTE_H
+#define _VDP_PALETTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Palette animation for the paletted screen modes - colour cycling and fades
+//
+// - a copy of the palette is kept here: vdp_pal_set() and the running effects change the copy,
+//   and vdp_pal_update() (call once a frame, after the vertical blank) sends a VDU 19 for only
+//   the entries that differ from what the VDP has, in one vdp_write
+// - a cycle rotates the colours of a range of entries one place every so many frames
+// - a fade moves a range of entries from their current colours to target colours over a number
+//   of frames - an entry can only be in one fade, a new fade takes it over
+// - only entries that have been given a colour (by vdp_pal_set or a fade) are ever sent, so set
+//   the colours of a cycle's range before starting it
+
+#define VDP_PAL_MAX			64			// most colours in a paletted mode
+#define VDP_PAL_EFFECTS		8			// cycles and fades running at once
+
+// Clear all effects and the palette copy (all black), and set the number of colours - 0 reads
+// it from the sysvars (after vdp_mode and vdp_get_scr_dims( true ))
+void vdp_pal_init( int colours );
+
+// Change an entry in the copy (sent by the next vdp_pal_update)
+void vdp_pal_set( int index, uint8_t r, uint8_t g, uint8_t b );
+void vdp_pal_get( int index, uint8_t *r, uint8_t *g, uint8_t *b );
+
+// Rotate entries first .. last one place every ticks frames, up (towards last) if dir > 0 or
+// down if dir < 0 - returns an effect id, or -1 if VDP_PAL_EFFECTS are already running
+int vdp_pal_cycle( int first, int last, int ticks, int dir );
+
+// Fade entries first .. last to rgb (3 bytes per entry, or NULL for black) over ticks frames
+// - returns an effect id, or -1; the effect ends itself when the fade is done
+int vdp_pal_fade( int first, int last, const uint8_t *rgb, int ticks );
+
+// Stop an effect, leaving its colours where they are
+void vdp_pal_stop( int id );
+bool vdp_pal_running( int id );
+
+// Run the effects one frame and send the entries that changed - returns the number sent
+int vdp_pal_update( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef _VDP_PRESENT_H
+#define _VDP_PRESENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Double buffered presentation, paced to the VDP, with damage rectangles
+//
+// - vdp_present_init() selects a double buffered mode and starts VDU batching, then each frame
+//   is drawn into the back buffer and shown with vdp_present()
+// - vdp_present() sends the batch, waits until the VDP has done the previous swap (so the program
+//   is never more than a frame ahead of the screen), and sends the swap, which the VDP does in
+//   the vertical blank, followed by a cursor position request - its reply marks the swap done
+// - damage: vdp_damage() records an area that changed this frame. It has to be redrawn in both
+//   buffers, as the other one still shows the old contents, so it's added to the lists of both,
+//   and vdp_present_damage() gives the areas to redraw in the buffer now being drawn - only
+//   what changed since that buffer was last shown
+// - rectangles are inclusive, in whatever coordinates the program draws with; overlapping ones
+//   are merged, and when a list is full it becomes one rectangle round everything
+
+#define VDP_DAMAGE_MAX		16			// rectangles kept per buffer
+
+typedef struct {
+	int16_t x0, y0;
+	int16_t x1, y1;
+} VDP_RECT;
+
+// Select mode (VDP double buffered modes are the mode number + 128) and send VDU output through
+// batch (batch_size bytes, e.g. 256) - the whole screen starts damaged in both buffers
+void vdp_present_init( int mode, char *batch, uint24_t batch_size );
+
+// Mark an area as changed / the whole screen (width x height, e.g. from the sysvars)
+void vdp_damage( int x0, int y0, int x1, int y1 );
+void vdp_damage_all( int width, int height );
+
+// Areas to redraw in the back buffer before the next vdp_present, returns how many
+int vdp_present_damage( const VDP_RECT **rects );
+
+// Show the back buffer - clears its damage list, as it's now up to date
+void vdp_present( void );
+
+// Buffer being drawn (0 or 1) and frames presented
+int vdp_present_back( void );
+uint24_t vdp_present_frames( void );
+
+// Stop batching (sends anything left)
+void vdp_present_end( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
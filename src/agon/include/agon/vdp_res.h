@@ -0,0 +1,63 @@
+#ifndef _VDP_RES_H
+#define _VDP_RES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <mos_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// VDP resource manager - buffer / bitmap IDs, residency and LRU eviction
+//
+// - IDs are handed out from a range set by vdp_res_init(), so modules no longer need their own
+//   hard-coded numbers (a buffer ID is also the bitmap ID used with vdp_adv_select_bitmap)
+// - each upload is keyed by a hash of its contents (or of the file name for files), and if the
+//   same data is already resident its ID is returned without sending anything
+// - uploads hold a reference until vdp_res_release() - released resources stay on the VDP as a
+//   cache, and the least recently used are cleared (vdp_adv_clear_buffer) when the memory
+//   budget would be exceeded or every ID is taken. The ID of an evicted resource is then
+//   reused, so only keep IDs that still hold a reference (or upload again, which is free if
+//   still resident)
+// - the key is a 32-bit FNV-1a hash plus the size, so different data is very unlikely (but not
+//   impossible) to match
+
+#define VDP_RES_MAX			64			// most resources tracked at once
+
+// Set the ID range (first_id .. first_id + count - 1, count up to VDP_RES_MAX) and the number of
+// bytes of VDP memory to use - clears any resources from a previous init
+void vdp_res_init( uint16_t first_id, uint16_t count, uint32_t budget );
+
+// Upload data to a buffer, returns its ID or -1 if it doesn't fit in the budget, or every ID
+// holds a reference
+int vdp_res_upload( const void *data, uint24_t len );
+
+// Upload an image and create a bitmap from it (format as vdp_adv_bitmap_from_buffer, 0 = RGBA8888)
+int vdp_res_bitmap( const void *data, uint24_t len, int width, int height, int format );
+
+// As vdp_res_bitmap, but the file is only read if it isn't resident already
+int vdp_res_bitmap_file( const char *fname, int width, int height, int format );
+
+// Reserve an ID and size for a buffer the caller fills itself (never matched by an upload)
+int vdp_res_alloc( uint24_t size );
+
+// Add / drop a reference - resources with no references may be evicted
+void vdp_res_retain( int id );
+void vdp_res_release( int id );
+
+// Mark as recently used (uploads and hits do this already)
+void vdp_res_touch( int id );
+
+// Clear the buffer on the VDP now
+void vdp_res_free( int id );
+
+// Whether id is still resident, and the bytes currently in use
+bool vdp_res_resident( int id );
+uint32_t vdp_res_used( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,7 +9,22 @@
 extern "C" {
 #endif
 
-#define VDP_PUTS(S) mos_puts( (char *)&(S), sizeof(S), 0)
+#define VDP_PUTS(S) vdp_write( &(S), sizeof(S) )
+
+// VDU batching - between vdp_batch_begin() and vdp_batch_end() the output of the vdp_* functions
+// (and anything else sent with vdp_write) is collected in buf and sent with one mos_puts when
+// it's full or on vdp_batch_flush(). Flush before output that doesn't go through vdp_write
+// (printf / putch) so the two stay in order. Calls that wait for a reply from the VDP
+// (vdp_get_scr_dims( true ), vdp_present, task_wait_vdp, agon::vdp_reply) flush the batch first,
+// so the request is sent - flush before waiting on vpd_pflags yourself.
+void vdp_batch_begin( char *buf, uint24_t size );
+void vdp_batch_end( void );
+void vdp_batch_flush( void );
+void vdp_write( const void *data, uint24_t len );
+
+// Called with everything sent through vdp_write - see vdp_capture_start()
+typedef void (*vdp_write_hook_t)( const void *data, uint24_t len );
+extern vdp_write_hook_t vdp_write_hook;
 
 volatile SYSVAR *vdp_vdu_init( void );
 void vdp_write_at_text_cursor( void );
@@ -47,6 +62,16 @@ void vdp_reset_viewports( void );
 void vdp_set_graphics_viewport( int left, int bottom, int right, int top );
 void vdp_set_text_viewport( int left, int bottom, int right, int top );
 
+// With vdp_clip_enable( true ), plots that would draw nothing inside the screen or graphics
+// viewport are dropped instead of sent, once vdp_get_scr_dims( true ) has read the screen size.
+// Their points still become the graphics cursor, and are sent as moves before the next plot that
+// is sent - call vdp_clip_sync() before anything else that uses the graphics cursor (e.g. text
+// after vdp_write_at_graphics_cursor), and vdp_clip_invalidate() after anything else that moves
+// it (fontlibc and vdu.hpp call it themselves)
+void vdp_clip_enable( bool flag );
+void vdp_clip_sync( void );
+void vdp_clip_invalidate( void );
+
 void vdp_plot( int plot_mode, int x, int y );
 void vdp_move_to( int x, int y );
 void vdp_line_to( int x, int y );
@@ -56,6 +81,12 @@ void vdp_circle_radius( int x, int y );
 void vdp_circle( int x, int y );
 void vdp_filled_rect( int x, int y );
 
+// Called with each block of RGBA data sent by the next vdp_load_bitmap_file() or
+// vdp_load_sprite_bitmaps() call (bitmap is the index within the call) - see vdp_mask_capture()
+typedef void (*vdp_load_hook_t)( int bitmap, int width, int height, uint24_t offset,
+								const uint8_t *data, uint24_t len );
+extern vdp_load_hook_t vdp_load_hook;
+
 void vdp_select_bitmap( int n );
 void vdp_load_bitmap( int width, int height, uint32_t *data );
 int vdp_load_bitmap_file( const char *fname, int width, int height );
@@ -86,6 +117,9 @@ void vdp_adv_create(int bufferID, int length);
 void vdp_adv_stream(int bufferID);
 void vdp_adv_adjust(int bufferID, int operation, int offset);
 void vdp_adv_consolidate(int bufferID);
+void vdp_adv_split(int bufferID, int blockSize);
+void vdp_adv_split_from(int bufferID, int blockSize, int targetID);
+void vdp_adv_split_width_from(int bufferID, int width, int count, int targetID);
 void vdp_adv_select_bitmap(int bufferId);
 void vdp_adv_bitmap_from_buffer(int width, int height, int format);
 
@@ -0,0 +1,231 @@
+#ifndef _VDU_HPP
+#define _VDU_HPP
+
+// Compile time VDU packets for C++
+//
+// - each command is a constexpr function returning a Packet<N> of its encoded bytes, and
+//   packets join with +, so a sequence of constant commands is encoded by the compiler:
+//       static constexpr auto title = vdu::mode( 8 ) + vdu::clear_screen() + vdu::cursor_enable( false );
+//       vdu::send( title );								// one vdp_write from .rodata
+// - commands with variable arguments are built in place, and a Batch collects them so that a
+//   frame of drawing goes to the VDP in one vdp_write:
+//       vdu::Batch<> batch;
+//       batch << vdu::move_to( x, y ) << vdu::line_to( x + w, y );
+//       batch.flush();									// also done by the destructor
+// - packets are sent with vdp_write, so they stay in order with the vdp_vdu.h functions inside
+//   vdp_batch_begin() / vdp_batch_end() and are seen by vdp_capture. Like those functions they
+//   shouldn't be sent from interrupt handlers; building packets has no state and is safe anywhere
+// - the encodings match vdp_vdu.c, and sending tells vdp_vdu.c's clipping that the graphics
+//   cursor may have moved (vdp_clip_invalidate)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vdp_vdu.h>
+
+namespace agon {
+namespace vdu {
+
+template <size_t N>
+struct Packet {
+	uint8_t data[N] = {};
+
+	static constexpr size_t size() { return N; }
+};
+
+template <size_t N, size_t M>
+constexpr Packet<N + M> operator+( const Packet<N> &a, const Packet<M> &b )
+{
+	Packet<N + M> p;
+
+	for ( size_t i = 0; i < N; i++ ) p.data[i] = a.data[i];
+	for ( size_t i = 0; i < M; i++ ) p.data[N + i] = b.data[i];
+	return p;
+}
+
+// Building blocks - single bytes and little endian 16-bit words
+
+template <class... T>
+constexpr Packet<sizeof...( T )> bytes( T... b )
+{
+	Packet<sizeof...( T )> p;
+	size_t i = 0;
+
+	( ( p.data[i++] = (uint8_t)b ), ... );
+	return p;
+}
+
+constexpr Packet<2> word( int w )
+{
+	return bytes( w & 0xFF, ( w >> 8 ) & 0xFF );
+}
+
+constexpr Packet<4> xy( int x, int y )
+{
+	return word( x ) + word( y );
+}
+
+// Output
+
+template <size_t N>
+inline void send( const Packet<N> &p )
+{
+	vdp_clip_invalidate();
+	vdp_write( p.data, N );
+}
+
+template <size_t N = 256>
+class Batch {
+public:
+	Batch() : len( 0 ) {}
+	~Batch() { flush(); }
+	Batch( const Batch & ) = delete;
+	Batch &operator=( const Batch & ) = delete;
+
+	template <size_t M>
+	Batch &operator<<( const Packet<M> &p ) {
+		static_assert( M <= N, "packet larger than the batch" );
+		if ( len + M > N ) flush();
+		for ( size_t i = 0; i < M; i++ ) buf[len + i] = p.data[i];
+		len += M;
+		return *this;
+	}
+
+	// Raw data following a command (e.g. bitmap or buffer contents)
+	Batch &write( const void *data, uint24_t n ) {
+		const uint8_t *s = static_cast<const uint8_t *>( data );
+
+		if ( len + n > N ) flush();
+		if ( n > N ) {
+			vdp_clip_invalidate();
+			vdp_write( s, n );
+			return *this;
+		}
+		for ( uint24_t i = 0; i < n; i++ ) buf[len + i] = s[i];
+		len += n;
+		return *this;
+	}
+
+	void flush() {
+		if ( len ) {
+			vdp_clip_invalidate();
+			vdp_write( buf, len );
+		}
+		len = 0;
+	}
+
+	uint24_t size() const { return len; }
+
+private:
+	uint8_t buf[N];
+	uint24_t len;
+};
+
+// Basic VDU commands
+
+constexpr Packet<1> write_at_text_cursor()		{ return bytes( 4 ); }
+constexpr Packet<1> write_at_graphics_cursor()	{ return bytes( 5 ); }
+constexpr Packet<1> enable_screen()				{ return bytes( 6 ); }
+constexpr Packet<1> bell()						{ return bytes( 7 ); }
+constexpr Packet<1> clear_screen()				{ return bytes( 12 ); }
+constexpr Packet<1> page_mode_on()				{ return bytes( 14 ); }
+constexpr Packet<1> page_mode_off()				{ return bytes( 15 ); }
+constexpr Packet<1> clear_graphics()			{ return bytes( 16 ); }
+constexpr Packet<1> reset_graphics()			{ return bytes( 20 ); }
+constexpr Packet<1> disable_screen()			{ return bytes( 21 ); }
+constexpr Packet<1> reset_viewports()			{ return bytes( 26 ); }
+constexpr Packet<1> cursor_home()				{ return bytes( 30 ); }
+
+constexpr Packet<2> text_colour( int colour )				{ return bytes( 17, colour ); }
+constexpr Packet<3> graphics_colour( int mode, int colour )	{ return bytes( 18, mode, colour ); }
+constexpr Packet<2> mode( int mode )						{ return bytes( 22, mode ); }
+constexpr Packet<3> cursor_tab( int col, int row )			{ return bytes( 31, col, row ); }
+constexpr Packet<5> graphics_origin( int x, int y )			{ return bytes( 29 ) + xy( x, y ); }
+
+constexpr Packet<6> define_colour( int logical, int physical, int red, int green, int blue )
+{
+	return bytes( 19, logical, physical, red, green, blue );
+}
+
+constexpr Packet<9> graphics_viewport( int left, int bottom, int right, int top )
+{
+	return bytes( 24 ) + xy( left, bottom ) + xy( right, top );
+}
+
+constexpr Packet<5> text_viewport( int left, int bottom, int right, int top )
+{
+	return bytes( 28, left, bottom, right, top );
+}
+
+// VDU 23 commands
+
+constexpr Packet<3> swap()							{ return bytes( 23, 0, 195 ); }
+constexpr Packet<3> get_scr_dims()					{ return bytes( 23, 0, 0x86 ); }
+constexpr Packet<4> logical_scr_dims( bool flag )	{ return bytes( 23, 0, 0xC0, flag ); }
+constexpr Packet<3> cursor_enable( bool flag )		{ return bytes( 23, 1, flag ); }
+
+constexpr Packet<5> scroll_screen_extent( int extent, int direction, int speed )
+{
+	return bytes( 23, 7, extent, direction, speed );
+}
+
+constexpr Packet<5> scroll_screen( int direction, int speed )
+{
+	return scroll_screen_extent( 1, direction, speed );
+}
+
+// Plot commands
+
+constexpr Packet<6> plot( int mode, int x, int y )	{ return bytes( 25, mode ) + xy( x, y ); }
+constexpr Packet<6> move_to( int x, int y )			{ return plot( 0x04, x, y ); }
+constexpr Packet<6> line_to( int x, int y )			{ return plot( 0x05, x, y ); }
+constexpr Packet<6> point( int x, int y )			{ return plot( 0x45, x, y ); }
+constexpr Packet<6> triangle( int x, int y )		{ return plot( 0x50, x, y ); }
+constexpr Packet<6> circle_radius( int x, int y )	{ return plot( 0x90, x, y ); }
+constexpr Packet<6> circle( int x, int y )			{ return plot( 0x94, x, y ); }
+constexpr Packet<6> filled_rect( int x, int y )		{ return plot( 0x65, x, y ); }
+
+// Bitmaps
+
+constexpr Packet<4> select_bitmap( int n )			{ return bytes( 23, 27, 0, n ); }
+constexpr Packet<7> load_bitmap( int w, int h )		{ return bytes( 23, 27, 1 ) + xy( w, h ); }	// + w * h * 4 bytes RGBA
+constexpr Packet<7> draw_bitmap( int x, int y )		{ return bytes( 23, 27, 3 ) + xy( x, y ); }
+
+constexpr Packet<11> solid_bitmap( int w, int h, int r, int g, int b, int a )
+{
+	return bytes( 23, 27, 2 ) + xy( w, h ) + bytes( r, g, b, a );
+}
+
+// Sprites
+
+constexpr Packet<4> sprite_select( int n )			{ return bytes( 23, 27, 4, n ); }
+constexpr Packet<3> sprite_clear()					{ return bytes( 23, 27, 5 ); }
+constexpr Packet<4> sprite_add_bitmap( int n )		{ return bytes( 23, 27, 6, n ); }
+constexpr Packet<4> sprite_activate( int n )		{ return bytes( 23, 27, 7, n ); }
+constexpr Packet<3> sprite_next_frame()				{ return bytes( 23, 27, 8 ); }
+constexpr Packet<3> sprite_prev_frame()				{ return bytes( 23, 27, 9 ); }
+constexpr Packet<4> sprite_nth_frame( int n )		{ return bytes( 23, 27, 10, n ); }
+constexpr Packet<3> sprite_show()					{ return bytes( 23, 27, 11 ); }
+constexpr Packet<3> sprite_hide()					{ return bytes( 23, 27, 12 ); }
+constexpr Packet<7> sprite_moveto( int x, int y )	{ return bytes( 23, 27, 13 ) + xy( x, y ); }
+constexpr Packet<7> sprite_moveby( int x, int y )	{ return bytes( 23, 27, 14 ) + xy( x, y ); }
+constexpr Packet<3> sprite_update()					{ return bytes( 23, 27, 15 ); }
+constexpr Packet<3> sprite_reset()					{ return bytes( 23, 27, 16 ); }
+
+// Buffered (bitmap id 0xFA00 + n) commands
+
+constexpr Packet<8> adv_write_block( int id, int size )	{ return bytes( 23, 0, 0xA0 ) + word( id ) + bytes( 0 ) + word( size ); }	// + size bytes
+constexpr Packet<6> adv_clear_buffer( int id )			{ return bytes( 23, 0, 0xA0 ) + word( id ) + bytes( 2 ); }
+constexpr Packet<8> adv_create( int id, int size )		{ return bytes( 23, 0, 0xA0 ) + word( id ) + bytes( 3 ) + word( size ); }
+constexpr Packet<6> adv_consolidate( int id )			{ return bytes( 23, 0, 0xA0 ) + word( id ) + bytes( 14 ); }
+constexpr Packet<5> adv_select_bitmap( int id )			{ return bytes( 23, 27, 0x20 ) + word( id ); }
+constexpr Packet<5> adv_add_sprite_bitmap( int id )		{ return bytes( 23, 27, 0x26 ) + word( id ); }
+
+constexpr Packet<8> adv_bitmap_from_buffer( int w, int h, int format )
+{
+	return bytes( 23, 27, 0x21 ) + xy( w, h ) + bytes( format );
+}
+
+} // namespace vdu
+} // namespace agon
+
+#endif
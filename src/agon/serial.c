@@ -0,0 +1,238 @@
+// Interrupt driven UART1 driver
+//
+// - MOS does not set up UART1 (vector 0x1A), so this installs its own ISR (uart1.src)
+// - the ISR moves bytes between the UART FIFOs and the RX / TX rings below
+// - the rings are 256 bytes indexed by 8-bit head / tail so wrap-around is free
+// - each index is only written by one side (ISR or main code) so no locking is needed
+//   except when the main code has to change the interrupt enables
+
+#include <agon/serial.h>
+#include <agon/ports.h>
+#include <mos_api.h>
+#include <stdlib.h>
+#include <string.h>
+#include <intce.h>
+
+// State shared with uart1.src - layout must match the offsets defined there
+
+typedef struct {
+	volatile uint8_t rx_head;		// written by ISR
+	volatile uint8_t rx_tail;		// written by ser_read
+	volatile uint8_t tx_head;		// written by ser_write
+	volatile uint8_t tx_tail;		// written by ISR
+	volatile uint8_t flags;
+	volatile uint8_t errors;
+} SER_STATE;
+
+#define SER_FLOW		0x01		// RTS/CTS flow control enabled
+#define SER_RTS_OFF		0x02		// RTS has been dropped by the ISR
+
+SER_STATE _agdev_ser;
+uint8_t _agdev_ser_rx_buf[SER_BUFFER_SIZE];
+uint8_t _agdev_ser_tx_buf[SER_BUFFER_SIZE];
+
+typedef void(*INTERRUPT_HANDLER)(void);
+
+extern void _agdev_uart1_handler( void );
+extern void _agdev_uart1_kick( void );
+extern void _agdev_uart1_rx_resume( void );
+
+extern int (*_stdio_dev_getc)( void );
+extern int (*_stdio_dev_putc)( int c );
+
+static INTERRUPT_HANDLER uart1_orig_handler = NULL;
+static bool ser_is_open = false;
+static bool ser_atexit_done = false;
+static FILE ser_file;
+
+static int ser_file_getc( void );
+static int ser_file_putc( int c );
+
+// Configure Port D pins for their alternate (UART1) function: DDR=1, ALT1=0, ALT2=1
+
+static void ser_set_pins( uint8_t mask )
+{
+	port_out( PD_DDR, port_in( PD_DDR ) | mask );
+	port_out( PD_ALT1, port_in( PD_ALT1 ) & ~mask );
+	port_out( PD_ALT2, port_in( PD_ALT2 ) | mask );
+}
+
+int ser_open( const UART *settings )
+{
+	uint24_t divisor;
+	uint8_t lctl;
+	uint8_t bits;
+
+	if ( ser_is_open || settings == NULL || settings->baudRate <= 0 ) return -1;
+
+	divisor = ( EZ80_SYS_CLOCK / 16 + settings->baudRate / 2 ) / settings->baudRate;
+	if ( divisor == 0 || divisor > 0xFFFF ) return -1;
+
+	bits = settings->dataBits ? settings->dataBits : 8;
+	if ( bits < 5 || bits > 8 ) return -1;
+	lctl = bits - 5;
+	if ( settings->stopBits == 2 ) lctl |= UART_LCTL_STOP2;
+	if ( settings->parity & 0x01 ) lctl |= UART_LCTL_PEN;
+	if ( settings->parity & 0x02 ) lctl |= UART_LCTL_PEN | UART_LCTL_EPS;
+
+	memset( &_agdev_ser, 0, sizeof( _agdev_ser ) );
+	if ( settings->flowcontrol ) _agdev_ser.flags = SER_FLOW;
+
+	port_out( UART1_IER, 0 );
+	ser_set_pins( settings->flowcontrol ? 0x0F : 0x03 );
+
+	port_out( UART1_LCTL, UART_LCTL_DLAB );
+	port_out( UART1_BRG_L, divisor & 0xFF );
+	port_out( UART1_BRG_H, divisor >> 8 );
+	port_out( UART1_LCTL, lctl );
+
+	port_out( UART1_FCTL, UART_FCTL_FIFOEN );
+	port_out( UART1_FCTL, UART_FCTL_FIFOEN | UART_FCTL_CLRRXF | UART_FCTL_CLRTXF | UART_FCTL_TRIG_8 );
+	port_out( UART1_MCTL, UART_MCTL_DTR | UART_MCTL_RTS );
+
+	uart1_orig_handler = mos_setintvector( UART1_IVECT, &_agdev_uart1_handler );
+	if ( !ser_atexit_done ) {
+		atexit( &ser_close );
+		ser_atexit_done = true;
+	}
+	ser_is_open = true;
+
+	port_out( UART1_IER, UART_IER_RIE );
+
+	return 0;
+}
+
+void ser_close( void )
+{
+	if ( !ser_is_open ) return;
+
+	ser_drain( 100 );
+
+	port_out( UART1_IER, 0 );
+	port_out( UART1_MCTL, 0 );
+	mos_setintvector( UART1_IVECT, uart1_orig_handler );
+
+	if ( _stdio_dev_getc == &ser_file_getc ) {
+		_stdio_dev_getc = NULL;
+		_stdio_dev_putc = NULL;
+	}
+	ser_is_open = false;
+}
+
+int ser_available( void )
+{
+	return (uint8_t)( _agdev_ser.rx_head - _agdev_ser.rx_tail );
+}
+
+int ser_tx_free( void )
+{
+	return SER_BUFFER_SIZE - 1 - (uint8_t)( _agdev_ser.tx_head - _agdev_ser.tx_tail );
+}
+
+int ser_read( void *buf, int len )
+{
+	uint8_t tail = _agdev_ser.rx_tail;
+	int avail = (uint8_t)( _agdev_ser.rx_head - tail );
+	int chunk;
+
+	if ( len > avail ) len = avail;
+	if ( len <= 0 ) return 0;
+
+	// Copy in at most two pieces - up to the end of the ring then from the start
+
+	chunk = SER_BUFFER_SIZE - tail;
+	if ( chunk > len ) chunk = len;
+	memcpy( buf, &_agdev_ser_rx_buf[tail], chunk );
+	if ( chunk < len ) memcpy( (uint8_t *)buf + chunk, _agdev_ser_rx_buf, len - chunk );
+
+	_agdev_ser.rx_tail = tail + len;
+
+	if ( _agdev_ser.flags & SER_RTS_OFF ) _agdev_uart1_rx_resume();
+
+	return len;
+}
+
+int ser_getc( void )
+{
+	uint8_t c;
+
+	return ser_read( &c, 1 ) ? c : -1;
+}
+
+int ser_write( const void *buf, int len )
+{
+	uint8_t head = _agdev_ser.tx_head;
+	int space = ser_tx_free();
+	int chunk;
+
+	if ( !ser_is_open ) return 0;
+	if ( len > space ) len = space;
+	if ( len <= 0 ) return 0;
+
+	chunk = SER_BUFFER_SIZE - head;
+	if ( chunk > len ) chunk = len;
+	memcpy( &_agdev_ser_tx_buf[head], buf, chunk );
+	if ( chunk < len ) memcpy( _agdev_ser_tx_buf, (const uint8_t *)buf + chunk, len - chunk );
+
+	_agdev_ser.tx_head = head + len;
+
+	// The ISR only runs while TIE is set, so start it off if the transmitter was idle
+
+	_agdev_uart1_kick();
+
+	return len;
+}
+
+bool ser_drain( uint24_t timeout )
+{
+	uint32_t start = getsysvar_time();
+
+	while ( _agdev_ser.tx_head != _agdev_ser.tx_tail || !( port_in( UART1_LSR ) & UART_LSR_TEMT ) ) {
+		if ( timeout && getsysvar_time() - start >= timeout ) return false;
+	}
+	return true;
+}
+
+// The UART1 ISR counts the errors, so read and clear them with interrupts off
+
+uint8_t ser_errors( void )
+{
+	uint8_t errors;
+
+	int_Disable();
+	errors = _agdev_ser.errors;
+	_agdev_ser.errors = 0;
+	int_Enable();
+	return errors;
+}
+
+// FILE* adaptor - hooks used by the libc stdio routines for FH_DEVICE streams
+
+static int ser_file_getc( void )
+{
+	int c;
+
+	while ( ( c = ser_getc() ) < 0 );
+	return c;
+}
+
+static int ser_file_putc( int c )
+{
+	uint8_t b = c;
+
+	while ( !ser_write( &b, 1 ) ) {
+		if ( !ser_is_open ) return EOF;
+	}
+	return c;
+}
+
+FILE *ser_fopen( const char *mode )
+{
+	if ( !ser_is_open || mode == NULL ) return NULL;
+
+	ser_file = (FILE){ FH_DEVICE, 0, 0, strchr( mode, 'b' ) == NULL, 0 };
+	_stdio_dev_getc = &ser_file_getc;
+	_stdio_dev_putc = &ser_file_putc;
+
+	return &ser_file;
+}
@@ -0,0 +1,213 @@
+// Cooperative tasks built on setjmp / longjmp
+//
+// - tasks are kept in a circular list starting with task 0 (main), and the scheduler walks it
+//   from the task after the current one, so ready tasks run round robin
+// - there is no idle task: if nothing is ready the scheduler keeps polling the wait conditions
+//   (the sysvar clock and VDP flags are updated by the MOS interrupt handlers)
+// - a task that ends can't free its own stack while still running on it, so it is marked dead
+//   and freed by the next task to pass it in the list
+
+#include <agon/task.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <intce.h>
+#include <vdp_vdu.h>
+
+enum {
+	TASK_NEW,							// spawned, not run yet
+	TASK_READY,
+	TASK_SLEEP,
+	TASK_FLAG,
+	TASK_COND,
+	TASK_DEAD
+};
+
+typedef struct TASK {
+	jmp_buf ctx;
+	struct TASK *next;
+	int id;
+	uint8_t state;
+	TASK_FN fn;
+	void *arg;
+	uint8_t *stack_top;
+	union {								// what a waiting task is waiting for
+		uint32_t wake;
+		struct { volatile uint8_t *flag; uint8_t mask; };
+		struct { bool (*cond)( void * ); void *cond_arg; };
+	};
+} TASK;
+
+static TASK task_main = { .next = &task_main, .id = 0, .state = TASK_READY };
+static TASK *task_current = &task_main;
+static int task_last_id = 0;
+static int task_total = 1;
+
+void _task_start( uint8_t *stack_top ) __attribute__((noreturn));
+
+static bool task_ready( TASK *t )
+{
+	switch ( t->state ) {
+		case TASK_NEW:
+		case TASK_READY:	return true;
+		case TASK_SLEEP:	return (int32_t)( getsysvar_time() - t->wake ) >= 0;
+		case TASK_FLAG:		return *t->flag & t->mask;
+		case TASK_COND:		return t->cond( t->cond_arg );
+		default:			return false;
+	}
+}
+
+// Find the next task to run, freeing any dead tasks on the way
+
+static TASK *task_pick( void )
+{
+	TASK *prev = task_current;
+
+	for ( ;; ) {
+		TASK *t = prev->next;
+
+		if ( t->state == TASK_DEAD && t != task_current ) {
+			prev->next = t->next;
+			free( t );
+			continue;
+		}
+		if ( task_ready( t ) ) return t;
+		prev = t;
+	}
+}
+
+static void task_resume( TASK *t ) __attribute__((noreturn));
+static void task_resume( TASK *t )
+{
+	uint8_t state = t->state;
+
+	task_current = t;
+	t->state = TASK_READY;
+	if ( state == TASK_NEW ) _task_start( t->stack_top );
+	longjmp( t->ctx, 1 );
+}
+
+// Run the next ready task - returns when the current task is resumed
+
+static void task_switch( void )
+{
+	TASK *t = task_pick();
+
+	if ( t == task_current ) {
+		t->state = TASK_READY;
+		return;
+	}
+	if ( task_current->state != TASK_DEAD && setjmp( task_current->ctx ) ) return;
+	task_resume( t );
+}
+
+// Entered from _task_start on the task's own stack
+
+void _task_entry( void ) __attribute__((noreturn));
+void _task_entry( void )
+{
+	task_current->fn( task_current->arg );
+	task_exit();
+}
+
+int task_spawn( TASK_FN fn, void *arg, size_t stack_size )
+{
+	TASK *t;
+
+	if ( stack_size == 0 ) stack_size = TASK_STACK_DEFAULT;
+	if ( stack_size < TASK_STACK_MIN ) stack_size = TASK_STACK_MIN;
+
+	// The stack follows the TASK structure in the same block
+
+	t = malloc( sizeof( TASK ) + stack_size );
+	if ( !t ) return -1;
+
+	t->fn = fn;
+	t->arg = arg;
+	t->stack_top = (uint8_t *)( t + 1 ) + stack_size;
+	t->state = TASK_NEW;
+	t->id = ++task_last_id;
+
+	// Insert after the current task, so it is the first to run at the next yield
+
+	t->next = task_current->next;
+	task_current->next = t;
+	task_total++;
+
+	return t->id;
+}
+
+void task_yield( void )
+{
+	task_current->state = TASK_READY;
+	task_switch();
+}
+
+void task_sleep_ticks( uint24_t ticks )
+{
+	task_current->wake = getsysvar_time() + ticks;
+	task_current->state = TASK_SLEEP;
+	task_switch();
+}
+
+void task_wait_flag( volatile uint8_t *flag, uint8_t mask )
+{
+	if ( *flag & mask ) return;
+	task_current->flag = flag;
+	task_current->mask = mask;
+	task_current->state = TASK_FLAG;
+	task_switch();
+}
+
+void task_wait_until( bool (*cond)( void *arg ), void *arg )
+{
+	if ( cond( arg ) ) return;
+	task_current->cond = cond;
+	task_current->cond_arg = arg;
+	task_current->state = TASK_COND;
+	task_switch();
+}
+
+// The VDP protocol handler sets the flags in an interrupt, so clear them with interrupts off
+
+void task_vdp_request( uint8_t mask )
+{
+	int_Disable();
+	_agdev_sysvars->vpd_pflags &= ~mask;
+	int_Enable();
+}
+
+void task_wait_vdp( uint8_t mask )
+{
+	vdp_batch_flush();							// send the request if it's in a batch
+	task_wait_flag( &_agdev_sysvars->vpd_pflags, mask );
+}
+
+void task_exit( void )
+{
+	if ( task_current == &task_main ) exit( 0 );
+	task_current->state = TASK_DEAD;
+	task_total--;
+	task_switch();
+	for ( ;; );											// not reached
+}
+
+int task_id( void )
+{
+	return task_current->id;
+}
+
+bool task_alive( int id )
+{
+	TASK *t = &task_main;
+
+	do {
+		if ( t->id == id ) return t->state != TASK_DEAD;
+		t = t->next;
+	} while ( t != &task_main );
+	return false;
+}
+
+int task_count( void )
+{
+	return task_total;
+}
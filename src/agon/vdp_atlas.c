@@ -0,0 +1,80 @@
+// Sprite sheet atlas loader
+
+#include <agon/vdp_atlas.h>
+#include <vdp_vdu.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ATLAS_HEADER_SIZE	12
+#define WRITE_BLOCK_MAX		0xFFFF
+
+int vdp_atlas_load( const char *fname, int first_id, int temp_id, VDP_ATLAS *info )
+{
+	uint8_t buf[256];
+	VDP_ATLAS atlas;
+	uint32_t frame_bytes, len;
+	bool blocks;
+	FILE *fp;
+	int i;
+
+	if ( !( fp = fopen( fname, "rb" ) ) ) return -1;
+	if ( fread( buf, 1, ATLAS_HEADER_SIZE, fp ) != ATLAS_HEADER_SIZE || memcmp( buf, "AGAT", 4 ) || buf[4] != 1 ) {
+		fclose( fp );
+		return -1;
+	}
+	atlas.format = buf[5];
+	atlas.width = buf[6] | buf[7] << 8;
+	atlas.height = buf[8] | buf[9] << 8;
+	atlas.frames = buf[10] | buf[11] << 8;
+	if ( info ) *info = atlas;
+
+	frame_bytes = (uint32_t)atlas.width * atlas.height * ( atlas.format == VDP_ATLAS_RGBA2222 ? 1 : 4 );
+	if ( !frame_bytes || frame_bytes > WRITE_BLOCK_MAX ) {
+		fclose( fp );
+		return -1;
+	}
+
+	// Send the whole image - each write block header is followed by its data in pieces
+
+	len = frame_bytes * atlas.frames;
+	blocks = len > WRITE_BLOCK_MAX;
+	vdp_adv_clear_buffer( temp_id );
+	while ( len ) {
+		uint24_t block = len > WRITE_BLOCK_MAX ? WRITE_BLOCK_MAX : len;
+
+		vdp_adv_write_block( temp_id, block );
+		len -= block;
+		while ( block ) {
+			size_t n = fread( buf, 1, block > sizeof( buf ) ? sizeof( buf ) : block, fp );
+
+			if ( !n ) {
+				// Short file - pad so the VDP isn't left waiting for data
+
+				memset( buf, 0, sizeof( buf ) );
+				while ( block ) {
+					n = block > sizeof( buf ) ? sizeof( buf ) : block;
+					vdp_write( buf, n );
+					block -= n;
+				}
+				fclose( fp );
+				vdp_adv_clear_buffer( temp_id );
+				return -1;
+			}
+			vdp_write( buf, n );
+			block -= n;
+		}
+	}
+	fclose( fp );
+	if ( blocks ) vdp_adv_consolidate( temp_id );
+
+	// Split into one buffer per frame and make the bitmaps
+
+	vdp_adv_split_from( temp_id, frame_bytes, first_id );
+	vdp_adv_clear_buffer( temp_id );
+	for ( i = 0; i < atlas.frames; i++ ) {
+		vdp_adv_select_bitmap( first_id + i );
+		vdp_adv_bitmap_from_buffer( atlas.width, atlas.height, atlas.format );
+	}
+
+	return atlas.frames;
+}
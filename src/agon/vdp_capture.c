@@ -0,0 +1,278 @@
+// VDU stream capture
+//
+// - vdp_write output comes in through vdp_write_hook, one call per write, and outchar through
+//   vdp_capture_char (vdp_capture_outchar.src), one character at a time
+// - commands are assembled in cap_hdr until their length is known: fixed for the VDU codes and
+//   the VDU 23 commands listed here, otherwise the command runs to the end of the vdp_write it
+//   came in (the vdp_* functions send one command per write)
+
+#include <agon/vdp_capture.h>
+#include <vdp_vdu.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CAP_HDR_MAX		16
+
+extern uint8_t vdp_capture_on;			// in vdp_capture_outchar.src
+
+// Length of VDU 0 - 31 including the code (23 depends on the next bytes)
+
+static const uint8_t vdu_len[32] = {
+	1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 2, 3, 6, 1, 1, 2, 0, 9, 6, 1, 2, 5, 5, 1, 3
+};
+
+// Length of VDU 23, 27, n for n = 0 .. 16
+
+static const uint8_t vdu_27_len[17] = { 4, 7, 11, 7, 4, 3, 4, 4, 3, 3, 4, 3, 3, 7, 7, 3, 3 };
+
+static VDP_CAPTURE_KEY cap_keys[VDP_CAPTURE_KEYS];
+static uint8_t cap_key_count;
+static uint8_t cap_key;					// key of the current command, for its data
+static VDP_CAPTURE_FRAME *cap_frames;
+static int cap_max_frames;
+static int cap_frame_count;
+static uint24_t cap_frame_bytes;
+static uint16_t cap_frame_commands;
+static uint8_t *cap_raw;
+static uint24_t cap_raw_size;
+static uint24_t cap_raw_len;
+static uint32_t cap_total;
+static uint8_t cap_hdr[CAP_HDR_MAX];
+static uint8_t cap_hdr_len;
+static uint32_t cap_data;				// bytes of data left for the current command
+
+// Total length of the command in cap_hdr, 0 if it runs to the end of the write, or -1 if more
+// bytes are needed to tell
+
+static int cmd_len( void )
+{
+	uint8_t c = cap_hdr[0];
+
+	if ( c != 23 ) return c < 32 ? vdu_len[c] : 1;
+	if ( cap_hdr_len < 2 ) return -1;
+	if ( cap_hdr[1] >= 32 ) return 10;						// character definition
+	if ( cap_hdr[1] == 1 ) return 3;						// cursor on / off
+	if ( cap_hdr[1] != 0 && cap_hdr[1] != 27 ) return 0;
+	if ( cap_hdr_len < 3 ) return -1;
+
+	if ( cap_hdr[1] == 27 ) {
+		c = cap_hdr[2];
+		if ( c <= 16 ) return vdu_27_len[c];
+		if ( c == 0x20 || c == 0x26 ) return 5;				// 16-bit bitmap id
+		if ( c == 0x21 ) return 8;							// bitmap from buffer
+		return 0;
+	}
+
+	switch ( cap_hdr[2] ) {
+	case 0xA0:												// buffer commands
+		if ( cap_hdr_len < 6 ) return -1;
+		switch ( cap_hdr[5] ) {
+		case 0: case 3: case 15:	return 8;
+		case 2: case 4: case 14:	return 6;
+		case 17:					return 10;
+		case 20:					return 12;
+		default:					return 0;
+		}
+	case 0x82: case 0x86: case 0xC3: case 0xCA: case 0xFF:
+		return 3;
+	case 0x80: case 0x81: case 0x94: case 0xC0: case 0xC1: case 0xFE:
+		return 4;
+	case 0x83: case 0x84:
+		return 7;
+	default:
+		return 0;
+	}
+}
+
+static void cmd_end( void )
+{
+	uint24_t key = cap_hdr[0] < 32 ? cap_hdr[0] : 32;
+	uint8_t i;
+
+	if ( key == 23 && cap_hdr_len > 1 ) {
+		if ( cap_hdr[1] >= 32 ) key |= 32 << 8;
+		else {
+			key |= cap_hdr[1] << 8;
+			if ( ( cap_hdr[1] == 0 || cap_hdr[1] == 27 ) && cap_hdr_len > 2 ) key |= (uint24_t)cap_hdr[2] << 16;
+		}
+	}
+
+	for ( i = 0; i < cap_key_count && cap_keys[i].key != key; i++ );
+	if ( i == cap_key_count ) {
+		if ( i == VDP_CAPTURE_KEYS ) i--;					// full - the last entry is the rest
+		else {
+			if ( i == VDP_CAPTURE_KEYS - 1 ) key = 0xFFFFFF;
+			cap_key_count++;
+			cap_keys[i].key = key;
+			cap_keys[i].commands = 0;
+			cap_keys[i].bytes = 0;
+		}
+	}
+	cap_keys[i].commands++;
+	cap_keys[i].bytes += cap_hdr_len;
+	cap_key = i;
+	cap_frame_commands++;
+
+	// Data following the command
+
+	cap_data = 0;
+	if ( cap_hdr_len == 7 && cap_hdr[0] == 23 && cap_hdr[1] == 27 && cap_hdr[2] == 1 )
+		cap_data = (uint32_t)( cap_hdr[3] | cap_hdr[4] << 8 ) * ( cap_hdr[5] | cap_hdr[6] << 8 ) * 4;
+	else if ( cap_hdr_len == 8 && cap_hdr[0] == 23 && cap_hdr[1] == 0 && cap_hdr[2] == 0xA0 && cap_hdr[5] == 0 )
+		cap_data = cap_hdr[6] | cap_hdr[7] << 8;
+	cap_hdr_len = 0;
+}
+
+static void capture( const uint8_t *p, uint24_t len, bool write_end )
+{
+	int n;
+
+	cap_total += len;
+	cap_frame_bytes += len;
+	if ( cap_raw_len < cap_raw_size ) {
+		n = cap_raw_size - cap_raw_len < len ? cap_raw_size - cap_raw_len : len;
+		memcpy( cap_raw + cap_raw_len, p, n );
+		cap_raw_len += n;
+	}
+
+	while ( len-- ) {
+		if ( cap_data ) {
+			cap_keys[cap_key].bytes++;
+			cap_data--;
+			p++;
+			continue;
+		}
+		cap_hdr[cap_hdr_len++] = *p++;
+		n = cmd_len();
+		if ( ( n > 0 && cap_hdr_len >= n ) || ( n == 0 && cap_hdr_len == CAP_HDR_MAX ) ) cmd_end();
+	}
+	if ( write_end && cap_hdr_len && cmd_len() == 0 ) cmd_end();
+}
+
+static void capture_write( const void *data, uint24_t len )
+{
+	capture( (const uint8_t *)data, len, true );
+}
+
+void vdp_capture_char( int c )
+{
+	uint8_t b = c;
+
+	capture( &b, 1, false );
+}
+
+void vdp_capture_start( VDP_CAPTURE_FRAME *frames, int max_frames, uint8_t *raw, uint24_t raw_size )
+{
+	cap_key_count = 0;
+	cap_frames = frames;
+	cap_max_frames = frames ? max_frames : 0;
+	cap_frame_count = 0;
+	cap_frame_bytes = 0;
+	cap_frame_commands = 0;
+	cap_raw = raw;
+	cap_raw_size = raw ? raw_size : 0;
+	cap_raw_len = 0;
+	cap_total = 0;
+	cap_hdr_len = 0;
+	cap_data = 0;
+
+	vdp_write_hook = capture_write;
+	vdp_capture_on = 1;
+}
+
+void vdp_capture_stop( void )
+{
+	vdp_write_hook = NULL;
+	vdp_capture_on = 0;
+}
+
+void vdp_capture_frame( void )
+{
+	if ( cap_frame_count < cap_max_frames ) {
+		cap_frames[cap_frame_count].bytes = cap_frame_bytes;
+		cap_frames[cap_frame_count].commands = cap_frame_commands;
+		cap_frame_count++;
+	}
+	cap_frame_bytes = 0;
+	cap_frame_commands = 0;
+}
+
+int vdp_capture_keys( const VDP_CAPTURE_KEY **keys )
+{
+	*keys = cap_keys;
+	return cap_key_count;
+}
+
+int vdp_capture_frames( void )
+{
+	return cap_frame_count;
+}
+
+uint32_t vdp_capture_total( void )
+{
+	return cap_total;
+}
+
+void vdp_capture_print( void )
+{
+	bool on = vdp_capture_on;
+	uint8_t done[VDP_CAPTURE_KEYS];
+
+	vdp_capture_stop();
+	memset( done, 0, sizeof( done ) );
+	printf( "%lu bytes, %d frames\r\n", cap_total, cap_frame_count );
+
+	// Largest first - a selection sort is fine for this few keys
+
+	for ( int n = 0; n < cap_key_count; n++ ) {
+		int best = -1;
+
+		for ( int i = 0; i < cap_key_count; i++ ) {
+			if ( !done[i] && ( best < 0 || cap_keys[i].bytes > cap_keys[best].bytes ) ) best = i;
+		}
+		done[best] = 1;
+		printf( "%3d,%3d,%3d  %6lu cmds %8lu bytes\r\n", (int)( cap_keys[best].key & 0xFF ),
+				(int)( ( cap_keys[best].key >> 8 ) & 0xFF ), (int)( cap_keys[best].key >> 16 ),
+				cap_keys[best].commands, cap_keys[best].bytes );
+	}
+	if ( on ) {
+		vdp_write_hook = capture_write;
+		vdp_capture_on = 1;
+	}
+}
+
+int vdp_capture_dump( const char *fname )
+{
+	static const uint8_t magic[5] = { 'A', 'G', 'V', 'C', 1 };
+	uint16_t count = cap_key_count;
+	uint24_t frames = cap_frame_count;
+	bool on = vdp_capture_on;
+	FILE *fp;
+	int i;
+
+	vdp_capture_stop();
+	if ( !( fp = fopen( fname, "wb" ) ) ) return -1;
+	fwrite( magic, 1, sizeof( magic ), fp );
+	fwrite( &count, 2, 1, fp );
+	for ( i = 0; i < cap_key_count; i++ ) {
+		fwrite( &cap_keys[i].key, 3, 1, fp );
+		fwrite( &cap_keys[i].commands, 4, 1, fp );
+		fwrite( &cap_keys[i].bytes, 4, 1, fp );
+	}
+	fwrite( &frames, 3, 1, fp );
+	for ( i = 0; i < cap_frame_count; i++ ) {
+		fwrite( &cap_frames[i].bytes, 3, 1, fp );
+		fwrite( &cap_frames[i].commands, 2, 1, fp );
+	}
+	fwrite( &cap_total, 4, 1, fp );
+	fwrite( &cap_raw_len, 3, 1, fp );
+	if ( cap_raw_len ) fwrite( cap_raw, 1, cap_raw_len, fp );
+	fclose( fp );
+
+	if ( on ) {
+		vdp_write_hook = capture_write;
+		vdp_capture_on = 1;
+	}
+	return 0;
+}
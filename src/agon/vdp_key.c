@@ -92,8 +92,8 @@ int vdp_key_init( void )
 	if ( !(mem_ptr = check_bytes_get_int( mem_ptr, fp3, &_agdev_vdp_protocol )) ) return -1;
 	if ( !(mem_ptr = check_bytes( mem_ptr, fp4 )) ) return -1;
 
-	vdp_ctrl_ptr = (VDP_CTRL *)(_agdev_vdp_protocol_data-6);
-	vdp_key_event_ptr = (KEY_EVENT *)_agdev_vdp_protocol_data;
+	vdp_ctrl_ptr = (VDP_CTRL *)(uintptr_t)(_agdev_vdp_protocol_data-6);
+	vdp_key_event_ptr = (KEY_EVENT *)(uintptr_t)_agdev_vdp_protocol_data;
 
 	// The above sets the 3 address in the interrupt code to the values from the original routine
 
@@ -163,13 +163,42 @@ void vdp_update_key_state( void )
 	return;
 }
 
-static uint8_t bit_masks[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
-
 bool vdp_check_key_press( uint8_t key_code )
 {
-	uint8_t mask = key_code & 0x07;
-	uint8_t byte = key_code >> 3;
-	return vdp_key_bits[byte] & bit_masks[mask];
+	return vdp_key_bits[KB_BYTE( key_code )] & KB_BIT( key_code );
+}
+
+// Keyboard snapshot - take once per frame, then test keys with the kb_Is* macros
+
+uint8_t kb_Data[32];
+uint8_t kb_Pressed[32];
+uint8_t kb_Released[32];
+
+// Shifted letters are separate vkeys (VK_A - VK_Z, bits 0x30 - 0x49), so they are added to the
+// unshifted ones (VK_a - VK_z, bits 0x16 - 0x2F, bytes 2 - 5 from bit 6) for KB_KEY_LETTER
+
+void kb_Scan( void )
+{
+	uint32_t shifted = ( vdp_key_bits[6] | (uint32_t)vdp_key_bits[7] << 8 | (uint32_t)vdp_key_bits[8] << 16 |
+						 (uint32_t)( vdp_key_bits[9] & 0x03 ) << 24 ) << 6;
+
+	for ( uint8_t i = 0; i < 32; i++ ) {
+		uint8_t prev = kb_Data[i];
+		uint8_t cur = vdp_key_bits[i];
+		if ( i >= 2 && i <= 5 ) cur |= (uint8_t)( shifted >> ( ( i - 2 ) * 8 ) );
+		kb_Data[i] = cur;
+		kb_Pressed[i] = cur & ~prev;
+		kb_Released[i] = prev & ~cur;
+	}
+}
+
+void kb_Reset( void )
+{
+	for ( uint8_t i = 0; i < 32; i++ ) {
+		kb_Data[i] = 0;
+		kb_Pressed[i] = 0;
+		kb_Released[i] = 0;
+	}
 }
 
 
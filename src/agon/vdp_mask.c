@@ -0,0 +1,176 @@
+// 1-bit collision masks
+//
+// - capture uses vdp_load_hook, so the loaders in vdp_vdu.c don't pull this file in unless
+//   masks are used
+// - the row ANDs are in vdp_mask_span.src; this file does the bounding box test and works out
+//   the overlapping rows and bytes
+
+#include <agon/vdp_mask.h>
+#include <vdp_vdu.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Rows to test, read by vdp_mask_span - keep the layout in step with vdp_mask_span.src
+
+typedef struct {
+	const uint8_t *a;					// +0  first byte of a to test
+	const uint8_t *b;					// +3  first byte of b
+	uint24_t a_stride;					// +6
+	uint24_t b_stride;					// +9
+	uint8_t count;						// +12 bytes of a to test per row
+	uint8_t b_bytes;					// +13 bytes of b per row
+	uint8_t shift;						// +14 b is shift pixels right of a's byte boundary
+	uint8_t rows;						// +15 1 - 255, counted down as the pointers are advanced
+} MASK_SPAN;
+
+uint8_t vdp_mask_span( MASK_SPAN *span );
+
+static VDP_MASK *capture_masks;
+static int capture_count;
+
+int vdp_mask_alloc( VDP_MASK *m, int width, int height )
+{
+	m->bits = NULL;
+	if ( width < 1 || width > VDP_MASK_MAX_WIDTH || height < 1 || height > 0xFFFF ) return -1;
+	m->width = width;
+	m->height = height;
+	m->stride = ( width + 7 ) >> 3;
+	m->bits = (uint8_t *)calloc( height, m->stride );
+	return m->bits ? 0 : -1;
+}
+
+void vdp_mask_free( VDP_MASK *m )
+{
+	free( m->bits );
+	m->bits = NULL;
+}
+
+// Set the mask bits for a run of RGBA8888 data starting offset bytes into the image
+// - the alpha is the last byte of each pixel
+
+static void mask_bytes( VDP_MASK *m, uint24_t offset, const uint8_t *data, uint24_t len )
+{
+	uint24_t i = ( 3 - offset ) & 3;
+	uint24_t pixel = ( offset + i ) >> 2;
+	uint24_t x = pixel % m->width;
+	uint8_t *row = m->bits + ( pixel / m->width ) * m->stride;
+
+	for ( ; i < len; i += 4 ) {
+		if ( data[i] >= VDP_MASK_ALPHA ) row[x >> 3] |= 0x80 >> ( x & 7 );
+		if ( ++x == m->width ) {
+			x = 0;
+			row += m->stride;
+		}
+	}
+}
+
+int vdp_mask_from_rgba( VDP_MASK *m, const uint32_t *pixels, int width, int height )
+{
+	if ( vdp_mask_alloc( m, width, height ) ) return -1;
+	mask_bytes( m, 0, (const uint8_t *)pixels, width * height * sizeof(uint32_t) );
+	return 0;
+}
+
+static void capture_hook( int bitmap, int width, int height, uint24_t offset,
+						const uint8_t *data, uint24_t len )
+{
+	VDP_MASK *m;
+
+	if ( bitmap >= capture_count ) return;
+	m = &capture_masks[bitmap];
+	if ( offset == 0 && vdp_mask_alloc( m, width, height ) ) return;
+	if ( m->bits ) mask_bytes( m, offset, data, len );
+}
+
+void vdp_mask_capture( VDP_MASK *masks, int count )
+{
+	if ( count > 0 ) memset( masks, 0, count * sizeof( VDP_MASK ) );
+	capture_masks = masks;
+	capture_count = count;
+	vdp_load_hook = count > 0 ? capture_hook : NULL;
+}
+
+int vdp_mask_load( const char *fname, VDP_MASK *masks, int max )
+{
+	uint8_t header[12];
+	FILE *fp;
+	int width, height, frames, n;
+
+	if ( !( fp = fopen( fname, "rb" ) ) ) return -1;
+	if ( fread( header, 1, sizeof( header ), fp ) != sizeof( header ) ||
+		 memcmp( header, "AGMK", 4 ) || header[4] != 1 ) {
+		fclose( fp );
+		return -1;
+	}
+	width = header[6] | ( header[7] << 8 );
+	height = header[8] | ( header[9] << 8 );
+	frames = header[10] | ( header[11] << 8 );
+	if ( frames > max ) frames = max;
+
+	for ( n = 0; n < frames; n++ ) {
+		VDP_MASK *m = &masks[n];
+
+		if ( vdp_mask_alloc( m, width, height ) ) break;
+		if ( fread( m->bits, m->stride, height, fp ) != (size_t)height ) {
+			vdp_mask_free( m );
+			break;
+		}
+	}
+	fclose( fp );
+	return n;
+}
+
+bool vdp_mask_overlap( const VDP_MASK *a, int ax, int ay, const VDP_MASK *b, int bx, int by )
+{
+	MASK_SPAN span;
+	int dx, dy, rows, count;
+
+	// Make b the one on the right, so it's shifted right to line up with a
+
+	if ( bx < ax ) {
+		const VDP_MASK *t = a; a = b; b = t;
+		dx = ax; ax = bx; bx = dx;
+		dy = ay; ay = by; by = dy;
+	}
+	if ( !a->bits || !b->bits ) return false;
+
+	dx = bx - ax;
+	if ( dx >= a->width ) return false;
+	dy = by - ay;
+	if ( dy >= 0 ) {
+		if ( dy >= a->height ) return false;
+		rows = a->height - dy;
+		if ( rows > b->height ) rows = b->height;
+		span.a = a->bits + dy * a->stride;
+		span.b = b->bits;
+	}
+	else {
+		if ( -dy >= b->height ) return false;
+		rows = b->height + dy;
+		if ( rows > a->height ) rows = a->height;
+		span.a = a->bits;
+		span.b = b->bits - dy * b->stride;
+	}
+
+	// a bytes from the one b starts in, up to the one b's last bits shift into
+
+	span.a += dx >> 3;
+	span.shift = dx & 7;
+	count = a->stride - ( dx >> 3 );
+	if ( count > b->stride + ( span.shift != 0 ) ) count = b->stride + ( span.shift != 0 );
+
+	span.a_stride = a->stride;
+	span.b_stride = b->stride;
+	span.count = count;
+	span.b_bytes = b->stride;
+
+	// vdp_mask_span takes up to 255 rows at a time, and leaves a and b at the next row
+
+	while ( rows > 0 ) {
+		span.rows = rows > 255 ? 255 : rows;
+		rows -= span.rows;
+		if ( vdp_mask_span( &span ) ) return true;
+	}
+	return false;
+}
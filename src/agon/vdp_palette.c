@@ -0,0 +1,179 @@
+// Palette animation
+//
+// - pal_rgb is the palette wanted, pal_sent what the VDP was last sent, so an update only sends
+//   the entries an effect (or vdp_pal_set) actually changed
+// - fades work out a fraction of the way (8.8 fixed point) once a frame rather than dividing
+//   for every colour
+
+#include <agon/vdp_palette.h>
+#include <vdp_vdu.h>
+#include <string.h>
+
+#define PAL_SET			0x01			// has a colour
+#define PAL_SENT		0x02			// pal_sent holds what the VDP has
+
+enum { EFFECT_NONE, EFFECT_CYCLE, EFFECT_FADE };
+
+typedef struct {
+	uint8_t type;
+	uint8_t first;
+	uint8_t last;
+	int8_t dir;
+	uint16_t ticks;						// cycle: frames per step, fade: frames to the end
+	uint16_t count;
+} PAL_EFFECT;
+
+static uint8_t pal_colours;
+static uint8_t pal_rgb[VDP_PAL_MAX][3];
+static uint8_t pal_sent[VDP_PAL_MAX][3];
+static uint8_t pal_flags[VDP_PAL_MAX];
+static uint8_t pal_from[VDP_PAL_MAX][3];
+static uint8_t pal_to[VDP_PAL_MAX][3];
+static int8_t pal_fade_id[VDP_PAL_MAX];	// fade that owns the entry, or -1
+static PAL_EFFECT pal_effects[VDP_PAL_EFFECTS];
+static uint8_t pal_batch[VDP_PAL_MAX * 6];
+
+void vdp_pal_init( int colours )
+{
+	if ( colours <= 0 ) colours = getsysvar_scrColours();
+	if ( colours > VDP_PAL_MAX ) colours = VDP_PAL_MAX;
+	pal_colours = colours;
+	memset( pal_rgb, 0, sizeof( pal_rgb ) );
+	memset( pal_flags, 0, sizeof( pal_flags ) );
+	memset( pal_fade_id, -1, sizeof( pal_fade_id ) );
+	memset( pal_effects, 0, sizeof( pal_effects ) );
+}
+
+void vdp_pal_set( int index, uint8_t r, uint8_t g, uint8_t b )
+{
+	if ( index < 0 || index >= pal_colours ) return;
+	pal_rgb[index][0] = r;
+	pal_rgb[index][1] = g;
+	pal_rgb[index][2] = b;
+	pal_flags[index] |= PAL_SET;
+}
+
+void vdp_pal_get( int index, uint8_t *r, uint8_t *g, uint8_t *b )
+{
+	if ( index < 0 || index >= pal_colours ) return;
+	*r = pal_rgb[index][0];
+	*g = pal_rgb[index][1];
+	*b = pal_rgb[index][2];
+}
+
+static int effect_new( int type, int first, int last, int ticks )
+{
+	if ( first < 0 || last >= pal_colours || first > last || ticks <= 0 ) return -1;
+	for ( int id = 0; id < VDP_PAL_EFFECTS; id++ ) {
+		PAL_EFFECT *e = &pal_effects[id];
+
+		if ( e->type == EFFECT_NONE ) {
+			e->type = type;
+			e->first = first;
+			e->last = last;
+			e->ticks = ticks;
+			e->count = 0;
+			return id;
+		}
+	}
+	return -1;
+}
+
+int vdp_pal_cycle( int first, int last, int ticks, int dir )
+{
+	int id = effect_new( EFFECT_CYCLE, first, last, ticks );
+
+	if ( id >= 0 ) pal_effects[id].dir = dir < 0 ? -1 : 1;
+	return id;
+}
+
+int vdp_pal_fade( int first, int last, const uint8_t *rgb, int ticks )
+{
+	int id = effect_new( EFFECT_FADE, first, last, ticks );
+
+	if ( id < 0 ) return -1;
+	for ( int i = first; i <= last; i++ ) {
+		memcpy( pal_from[i], pal_rgb[i], 3 );
+		if ( rgb ) memcpy( pal_to[i], rgb + ( i - first ) * 3, 3 );
+		else memset( pal_to[i], 0, 3 );
+		pal_fade_id[i] = id;
+		pal_flags[i] |= PAL_SET;
+	}
+	return id;
+}
+
+void vdp_pal_stop( int id )
+{
+	if ( id < 0 || id >= VDP_PAL_EFFECTS ) return;
+	for ( int i = 0; i < VDP_PAL_MAX; i++ ) {
+		if ( pal_fade_id[i] == id ) pal_fade_id[i] = -1;
+	}
+	pal_effects[id].type = EFFECT_NONE;
+}
+
+bool vdp_pal_running( int id )
+{
+	return id >= 0 && id < VDP_PAL_EFFECTS && pal_effects[id].type != EFFECT_NONE;
+}
+
+static void cycle_step( PAL_EFFECT *e )
+{
+	uint8_t keep[3];
+
+	if ( ++e->count < e->ticks ) return;
+	e->count = 0;
+	if ( e->dir > 0 ) {
+		memcpy( keep, pal_rgb[e->last], 3 );
+		memmove( pal_rgb[e->first + 1], pal_rgb[e->first], ( e->last - e->first ) * 3 );
+		memcpy( pal_rgb[e->first], keep, 3 );
+	}
+	else {
+		memcpy( keep, pal_rgb[e->first], 3 );
+		memmove( pal_rgb[e->first], pal_rgb[e->first + 1], ( e->last - e->first ) * 3 );
+		memcpy( pal_rgb[e->last], keep, 3 );
+	}
+}
+
+static void fade_step( int id, PAL_EFFECT *e )
+{
+	int frac = ( (uint32_t)++e->count << 8 ) / e->ticks;		// 0 .. 256
+
+	for ( int i = e->first; i <= e->last; i++ ) {
+		if ( pal_fade_id[i] != id ) continue;		// taken over by a later fade
+		for ( int c = 0; c < 3; c++ ) {
+			int from = pal_from[i][c];
+
+			pal_rgb[i][c] = from + ( ( ( pal_to[i][c] - from ) * frac ) >> 8 );
+		}
+	}
+	if ( e->count >= e->ticks ) vdp_pal_stop( id );
+}
+
+int vdp_pal_update( void )
+{
+	uint8_t *p = pal_batch;
+	int n = 0;
+
+	for ( int id = 0; id < VDP_PAL_EFFECTS; id++ ) {
+		PAL_EFFECT *e = &pal_effects[id];
+
+		if ( e->type == EFFECT_CYCLE ) cycle_step( e );
+		else if ( e->type == EFFECT_FADE ) fade_step( id, e );
+	}
+
+	for ( int i = 0; i < pal_colours; i++ ) {
+		if ( !( pal_flags[i] & PAL_SET ) ) continue;
+		if ( ( pal_flags[i] & PAL_SENT ) && !memcmp( pal_sent[i], pal_rgb[i], 3 ) ) continue;
+		memcpy( pal_sent[i], pal_rgb[i], 3 );
+		pal_flags[i] |= PAL_SENT;
+		*p++ = 19;									// VDU 19, l, 255, r, g, b
+		*p++ = i;
+		*p++ = 255;
+		*p++ = pal_rgb[i][0];
+		*p++ = pal_rgb[i][1];
+		*p++ = pal_rgb[i][2];
+		n++;
+	}
+	if ( n ) vdp_write( pal_batch, p - pal_batch );
+	return n;
+}
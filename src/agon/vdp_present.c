@@ -0,0 +1,136 @@
+// Double buffered presentation
+//
+// - the cursor position request (VDU 23, 0, &82) is only used for its reply: the VDP handles
+//   commands in order, so vdp_pflag_cursor is set once the swap before it has been done
+// - if the VDP never replies (older firmware), the wait gives up after PRESENT_TIMEOUT
+
+#include <agon/vdp_present.h>
+#include <vdp_vdu.h>
+#include <intce.h>
+
+#define PRESENT_TIMEOUT		10			// centiseconds, over a frame at 50Hz
+
+typedef struct {
+	VDP_RECT rects[VDP_DAMAGE_MAX];
+	uint8_t count;
+} DAMAGE;
+
+static const uint8_t vdu_request_cursor[] = { 23, 0, 0x82 };
+
+static DAMAGE present_damage[2];
+static uint8_t present_back;
+static bool present_pending;
+static uint24_t present_frames;
+
+static bool rect_touch( const VDP_RECT *a, const VDP_RECT *b )
+{
+	return a->x0 <= b->x1 + 1 && b->x0 <= a->x1 + 1 && a->y0 <= b->y1 + 1 && b->y0 <= a->y1 + 1;
+}
+
+static void rect_union( VDP_RECT *a, const VDP_RECT *b )
+{
+	if ( b->x0 < a->x0 ) a->x0 = b->x0;
+	if ( b->y0 < a->y0 ) a->y0 = b->y0;
+	if ( b->x1 > a->x1 ) a->x1 = b->x1;
+	if ( b->y1 > a->y1 ) a->y1 = b->y1;
+}
+
+// Add a rectangle to a list, merging it with any it overlaps or touches
+
+static void damage_add( DAMAGE *d, VDP_RECT r )
+{
+	uint8_t i = 0;
+
+	while ( i < d->count ) {
+		if ( rect_touch( &d->rects[i], &r ) ) {
+			rect_union( &r, &d->rects[i] );
+			d->rects[i] = d->rects[--d->count];		// the merged one may now touch others
+			i = 0;
+		}
+		else i++;
+	}
+	if ( d->count == VDP_DAMAGE_MAX ) {
+		for ( i = 0; i < d->count; i++ ) rect_union( &r, &d->rects[i] );
+		d->count = 0;
+	}
+	d->rects[d->count++] = r;
+}
+
+void vdp_present_init( int mode, char *batch, uint24_t batch_size )
+{
+	vdp_mode( mode );
+	vdp_get_scr_dims( true );
+	vdp_batch_begin( batch, batch_size );
+
+	present_back = 0;
+	present_pending = false;
+	present_frames = 0;
+	present_damage[0].count = present_damage[1].count = 0;
+	vdp_damage_all( _agdev_sysvars->scrWidth, _agdev_sysvars->scrHeight );
+}
+
+void vdp_damage( int x0, int y0, int x1, int y1 )
+{
+	VDP_RECT r;
+
+	r.x0 = x0 < x1 ? x0 : x1;
+	r.x1 = x0 < x1 ? x1 : x0;
+	r.y0 = y0 < y1 ? y0 : y1;
+	r.y1 = y0 < y1 ? y1 : y0;
+	damage_add( &present_damage[0], r );
+	damage_add( &present_damage[1], r );
+}
+
+void vdp_damage_all( int width, int height )
+{
+	present_damage[0].count = present_damage[1].count = 0;
+	vdp_damage( 0, 0, width - 1, height - 1 );
+}
+
+int vdp_present_damage( const VDP_RECT **rects )
+{
+	DAMAGE *d = &present_damage[present_back];
+
+	*rects = d->rects;
+	return d->count;
+}
+
+void vdp_present( void )
+{
+	present_damage[present_back].count = 0;
+	vdp_batch_flush();
+
+	if ( present_pending ) {
+		uint32_t start = getsysvar_time();
+
+		while ( !( _agdev_sysvars->vpd_pflags & vdp_pflag_cursor ) &&
+				getsysvar_time() - start < PRESENT_TIMEOUT );
+	}
+
+	int_Disable();
+	_agdev_sysvars->vpd_pflags &= ~vdp_pflag_cursor;
+	int_Enable();
+
+	vdp_swap();
+	vdp_write( vdu_request_cursor, sizeof( vdu_request_cursor ) );
+	vdp_batch_flush();
+
+	present_pending = true;
+	present_back ^= 1;
+	present_frames++;
+}
+
+int vdp_present_back( void )
+{
+	return present_back;
+}
+
+uint24_t vdp_present_frames( void )
+{
+	return present_frames;
+}
+
+void vdp_present_end( void )
+{
+	vdp_batch_end();
+}
@@ -0,0 +1,297 @@
+// VDP resource manager
+//
+// - the table index is the ID offset, so lookups by ID are direct and a free slot is a free ID
+// - eviction and matching scan the table, which is small (VDP_RES_MAX entries)
+
+#include <agon/vdp_res.h>
+#include <vdp_vdu.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FNV_OFFSET		0x811C9DC5UL
+#define FNV_PRIME		0x01000193UL
+
+#define RES_USED		0x01
+#define RES_KEYED		0x02			// has a content key (not from vdp_res_alloc)
+
+#define WRITE_BLOCK_MAX	0xFFFF			// write block length is 16-bit
+
+typedef struct {
+	uint32_t key;
+	uint24_t size;
+	uint24_t stamp;						// last use, for LRU
+	uint8_t refs;
+	uint8_t flags;
+} VDP_RES;
+
+static VDP_RES res_table[VDP_RES_MAX];
+static uint16_t res_first_id;
+static uint8_t res_count;
+static uint32_t res_budget;
+static uint32_t res_used;
+static uint24_t res_clock;
+
+static uint32_t fnv1a( uint32_t h, const void *data, uint24_t len )
+{
+	const uint8_t *p = data;
+
+	while ( len-- ) {
+		h ^= *p++;
+		h *= FNV_PRIME;
+	}
+	return h;
+}
+
+static int res_id( VDP_RES *r )
+{
+	return res_first_id + ( r - res_table );
+}
+
+static VDP_RES *res_get( int id )
+{
+	int i = id - res_first_id;
+
+	if ( i < 0 || i >= res_count || !( res_table[i].flags & RES_USED ) ) return NULL;
+	return &res_table[i];
+}
+
+static void res_drop( VDP_RES *r )
+{
+	vdp_adv_clear_buffer( res_id( r ) );
+	res_used -= r->size;
+	r->flags = 0;
+}
+
+// The least recently used resource with no references, or NULL
+
+static VDP_RES *res_oldest( void )
+{
+	VDP_RES *oldest = NULL;
+	uint8_t i;
+
+	for ( i = 0; i < res_count; i++ ) {
+		VDP_RES *r = &res_table[i];
+
+		if ( ( r->flags & RES_USED ) && !r->refs && ( !oldest || r->stamp < oldest->stamp ) ) oldest = r;
+	}
+	return oldest;
+}
+
+// Make room for size more bytes, evicting unreferenced resources oldest first
+
+static bool res_make_room( uint24_t size )
+{
+	while ( res_used + size > res_budget ) {
+		VDP_RES *oldest = res_oldest();
+
+		if ( !oldest ) return false;
+		res_drop( oldest );
+	}
+	return true;
+}
+
+static VDP_RES *res_find( uint32_t key, uint24_t size )
+{
+	uint8_t i;
+
+	for ( i = 0; i < res_count; i++ ) {
+		VDP_RES *r = &res_table[i];
+
+		if ( ( r->flags & RES_KEYED ) && r->key == key && r->size == size ) return r;
+	}
+	return NULL;
+}
+
+// Take a free slot with room for size bytes, or NULL - if every ID is taken the least recently
+// used unreferenced resource is evicted for its ID, even when the budget has room
+
+static VDP_RES *res_new( uint32_t key, uint24_t size, uint8_t flags )
+{
+	VDP_RES *r = NULL;
+	uint8_t i;
+
+	if ( size > res_budget || !res_make_room( size ) ) return NULL;
+	for ( i = 0; i < res_count && !r; i++ ) {
+		if ( !( res_table[i].flags & RES_USED ) ) r = &res_table[i];
+	}
+	if ( r ) vdp_adv_clear_buffer( res_id( r ) );
+	else if ( ( r = res_oldest() ) ) res_drop( r );				// clears the buffer
+	else return NULL;
+
+	r->key = key;
+	r->size = size;
+	r->refs = 1;
+	r->flags = RES_USED | flags;
+	r->stamp = ++res_clock;
+	res_used += size;
+	return r;
+}
+
+static VDP_RES *res_hit( VDP_RES *r )
+{
+	r->refs++;
+	r->stamp = ++res_clock;
+	return r;
+}
+
+// Send data as write blocks (consolidated if there is more than one)
+
+static void res_send( int id, const uint8_t *data, uint24_t len )
+{
+	bool blocks = len > WRITE_BLOCK_MAX;
+
+	while ( len ) {
+		uint24_t n = len > WRITE_BLOCK_MAX ? WRITE_BLOCK_MAX : len;
+
+		vdp_adv_write_block( id, n );
+		vdp_write( data, n );
+		data += n;
+		len -= n;
+	}
+	if ( blocks ) vdp_adv_consolidate( id );
+}
+
+void vdp_res_init( uint16_t first_id, uint16_t count, uint32_t budget )
+{
+	uint8_t i;
+
+	for ( i = 0; i < res_count; i++ ) {
+		if ( res_table[i].flags & RES_USED ) res_drop( &res_table[i] );
+	}
+	res_first_id = first_id;
+	res_count = count > VDP_RES_MAX ? VDP_RES_MAX : count;
+	res_budget = budget;
+	res_used = 0;
+}
+
+int vdp_res_upload( const void *data, uint24_t len )
+{
+	uint32_t key = fnv1a( FNV_OFFSET, data, len );
+	VDP_RES *r = res_find( key, len );
+
+	if ( r ) return res_id( res_hit( r ) );
+	if ( !( r = res_new( key, len, RES_KEYED ) ) ) return -1;
+	res_send( res_id( r ), data, len );
+	return res_id( r );
+}
+
+static uint32_t bitmap_key( uint32_t h, int width, int height, int format )
+{
+	int dims[3];
+
+	dims[0] = width;
+	dims[1] = height;
+	dims[2] = format;
+	return fnv1a( h, dims, sizeof( dims ) );
+}
+
+static void res_make_bitmap( int id, int width, int height, int format )
+{
+	vdp_adv_select_bitmap( id );
+	vdp_adv_bitmap_from_buffer( width, height, format );
+}
+
+int vdp_res_bitmap( const void *data, uint24_t len, int width, int height, int format )
+{
+	uint32_t key = bitmap_key( fnv1a( FNV_OFFSET, data, len ), width, height, format );
+	VDP_RES *r = res_find( key, len );
+
+	if ( r ) return res_id( res_hit( r ) );
+	if ( !( r = res_new( key, len, RES_KEYED ) ) ) return -1;
+	res_send( res_id( r ), data, len );
+	res_make_bitmap( res_id( r ), width, height, format );
+	return res_id( r );
+}
+
+int vdp_res_bitmap_file( const char *fname, int width, int height, int format )
+{
+	uint8_t buf[256];
+	uint32_t key;
+	uint24_t len;
+	long size;
+	VDP_RES *r;
+	FILE *fp;
+	int id;
+
+	if ( !( fp = fopen( fname, "rb" ) ) ) return -1;
+	fseek( fp, 0, SEEK_END );
+	size = ftell( fp );
+	fseek( fp, 0, SEEK_SET );
+
+	// Key on the file name and size - the contents are only read for an upload
+
+	key = bitmap_key( fnv1a( FNV_OFFSET, fname, strlen( fname ) ), width, height, format ) ^ 0x80000000UL;
+	len = size;
+	if ( ( r = res_find( key, len ) ) ) {
+		fclose( fp );
+		return res_id( res_hit( r ) );
+	}
+	if ( !( r = res_new( key, len, RES_KEYED ) ) ) {
+		fclose( fp );
+		return -1;
+	}
+
+	id = res_id( r );
+	while ( len ) {
+		size_t n = fread( buf, 1, len > sizeof( buf ) ? sizeof( buf ) : len, fp );
+
+		if ( !n ) break;
+		vdp_adv_write_block( id, n );
+		vdp_write( buf, n );
+		len -= n;
+	}
+	fclose( fp );
+
+	if ( len ) {									// file shorter than its size
+		res_drop( r );
+		return -1;
+	}
+	vdp_adv_consolidate( id );
+	res_make_bitmap( id, width, height, format );
+	return id;
+}
+
+int vdp_res_alloc( uint24_t size )
+{
+	VDP_RES *r = res_new( 0, size, 0 );
+
+	return r ? res_id( r ) : -1;
+}
+
+void vdp_res_retain( int id )
+{
+	VDP_RES *r = res_get( id );
+
+	if ( r ) r->refs++;
+}
+
+void vdp_res_release( int id )
+{
+	VDP_RES *r = res_get( id );
+
+	if ( r && r->refs ) r->refs--;
+}
+
+void vdp_res_touch( int id )
+{
+	VDP_RES *r = res_get( id );
+
+	if ( r ) r->stamp = ++res_clock;
+}
+
+void vdp_res_free( int id )
+{
+	VDP_RES *r = res_get( id );
+
+	if ( r ) res_drop( r );
+}
+
+bool vdp_res_resident( int id )
+{
+	return res_get( id ) != NULL;
+}
+
+uint32_t vdp_res_used( void )
+{
+	return res_used;
+}
@@ -5,6 +5,7 @@
 #include <mos_api.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 // Different patterns for the VDU commands
 // - when defining VDU commands the values A, B and CMD should be set in the structure initialiser
@@ -30,15 +31,90 @@ typedef struct { uint8_t A; uint8_t B; uint8_t CMD; uint16_t w; uint16_t h; uint
 typedef struct { uint8_t A; uint8_t B; uint8_t C; uint16_t BID; uint8_t CMD; } VDU_ADV_CMD;
 typedef struct { uint8_t A; uint8_t B; uint8_t C; uint16_t BID; uint8_t CMD; uint16_t ui16; } VDU_ADV_CMD_ui16;
 typedef struct { uint8_t A; uint8_t B; uint8_t C; uint16_t BID; uint8_t CMD; uint8_t ui8; uint16_t ui16; } VDU_ADV_CMD_ui8_ui16;
+typedef struct { uint8_t A; uint8_t B; uint8_t C; uint16_t BID; uint8_t CMD; uint16_t ui16a; uint16_t ui16b; } VDU_ADV_CMD_ui16_ui16;
+typedef struct { uint8_t A; uint8_t B; uint8_t C; uint16_t BID; uint8_t CMD; uint16_t ui16a; uint16_t ui16b; uint16_t ui16c; } VDU_ADV_CMD_ui16x3;
 typedef struct { uint8_t A; uint8_t B; uint8_t b0; uint8_t b1; uint8_t b2; uint8_t b3; uint8_t b4; uint8_t b5; uint8_t b6; uint8_t b7; } VDU_A_B_ui8x8;
 typedef struct { uint8_t A; uint16_t w0; uint16_t w1; uint16_t w2; uint16_t w3; } VDU_A_ui16x4;
 
-static volatile SYSVAR *sys_vars = NULL;
+// The SYSVAR pointer is cached by crt0 (_agdev_sysvars) - this is kept for existing code
 
 volatile SYSVAR *vdp_vdu_init( void )
 {
-	sys_vars = (SYSVAR *)mos_sysvars();
-	return (SYSVAR *)sys_vars;
+	return _agdev_sysvars;
+}
+
+// VDU batching - see vdp_batch_begin()
+
+static char *batch_buf = NULL;
+static uint24_t batch_size;
+static uint24_t batch_len;
+
+void vdp_batch_begin( char *buf, uint24_t size )
+{
+	vdp_batch_flush();
+	batch_buf = size ? buf : NULL;
+	batch_size = size;
+	batch_len = 0;
+}
+
+void vdp_batch_end( void )
+{
+	vdp_batch_flush();
+	batch_buf = NULL;
+}
+
+void vdp_batch_flush( void )
+{
+	if ( batch_len ) mos_puts( batch_buf, batch_len, 0 );
+	batch_len = 0;
+}
+
+// Set by vdp_capture_start to see everything sent
+
+vdp_write_hook_t vdp_write_hook = NULL;
+
+void vdp_write( const void *data, uint24_t len )
+{
+	if ( vdp_write_hook ) vdp_write_hook( data, len );
+	if ( !batch_buf ) {
+		mos_puts( (char *)data, len, 0 );
+		return;
+	}
+	if ( batch_len + len > batch_size ) {
+		vdp_batch_flush();
+		if ( len > batch_size ) {						// too big to batch
+			mos_puts( (char *)data, len, 0 );
+			return;
+		}
+	}
+	memcpy( batch_buf + batch_len, data, len );
+	batch_len += len;
+}
+
+// Graphics clip state - see clip_plot()
+
+static bool clip_enabled = false;
+static bool clip_known = false;
+static bool clip_logical = true;
+static int clip_x0, clip_y0, clip_x1, clip_y1;
+static int origin_x, origin_y;
+static int gcur_x[2], gcur_y[2];		// [0] is the latest point
+static uint8_t gcur_stale;				// number of them not yet sent
+static uint8_t gcur_known = 2;			// number of them that are the VDP's - see vdp_clip_invalidate()
+
+static void clip_set( int x0, int y0, int x1, int y1 )
+{
+	clip_x0 = x0 < x1 ? x0 : x1;
+	clip_x1 = x0 < x1 ? x1 : x0;
+	clip_y0 = y0 < y1 ? y0 : y1;
+	clip_y1 = y0 < y1 ? y1 : y0;
+}
+
+static void clip_screen( void )
+{
+	if ( clip_logical ) clip_set( 0, 0, 1279, 1023 );
+	else clip_set( 0, 0, _agdev_sysvars->scrWidth - 1, _agdev_sysvars->scrHeight - 1 );
+	clip_known = _agdev_sysvars->scrWidth != 0;
 }
 
 // Basic VDU commands
@@ -119,6 +195,14 @@ int vdp_mode( int mode )
 	if ( mode < 0 || mode >= 255 ) return -1;
 	vdu_mode.n = mode;
 	VDP_PUTS( vdu_mode );
+
+	// The new screen size isn't known until vdp_get_scr_dims( true )
+	clip_known = false;
+	clip_logical = true;
+	origin_x = origin_y = 0;
+	gcur_x[0] = gcur_y[0] = gcur_x[1] = gcur_y[1] = 0;
+	gcur_stale = 0;
+	gcur_known = 2;
 	return mode;
 }
 
@@ -127,6 +211,8 @@ void vdp_graphics_origin( int x, int y )
 	vdu_graphics_origin.x = x;
 	vdu_graphics_origin.y = y;
 	VDP_PUTS( vdu_graphics_origin );
+	origin_x = x;
+	origin_y = y;
 }
 
 // VDU 23 commands
@@ -153,14 +239,16 @@ void vdp_redefine_character( int chnum, uint8_t b0, uint8_t b1, uint8_t b2, uint
 
 void vdp_get_scr_dims( bool wait )
 {
-	if ( !sys_vars ) vdp_vdu_init();
-
-	if ( wait ) sys_vars->vpd_pflags = 0;
+	if ( wait ) _agdev_sysvars->vpd_pflags = 0;
 
 	VDP_PUTS( vdu_get_scr_dims );
 
 	// wait for results of mode change to be reflected in SYSVARs
-	if ( wait ) while ( !(sys_vars->vpd_pflags & vdp_pflag_mode) );
+	if ( wait ) {
+		vdp_batch_flush();						// the request may be waiting in the batch
+		while ( !(_agdev_sysvars->vpd_pflags & vdp_pflag_mode) );
+		clip_screen();
+	}
 }
 
 void vdp_logical_scr_dims( bool flag )
@@ -168,6 +256,8 @@ void vdp_logical_scr_dims( bool flag )
 	vdu_set_logical_scr_dims.n = 0;
 	if ( flag ) vdu_set_logical_scr_dims.n = 1;
 	VDP_PUTS( vdu_set_logical_scr_dims );
+	clip_logical = flag;
+	if ( clip_known ) clip_screen();
 }
 
 void vdp_cursor_enable( bool flag )
@@ -199,9 +289,14 @@ static VDU_A vdu_reset_viewports = { 26 };
 static VDU_A_ui16x4 vdu_set_graphics_viewport = { 24, 0, 0, 0, 0 };
 static VDU_A_a_b_c_d vdu_set_text_viewport = { 28, 0, 0, 0, 0 };
 
-void vdp_reset_viewports( void ) { VDP_PUTS( vdu_reset_viewports ); }
+void vdp_reset_viewports( void )
+{
+	VDP_PUTS( vdu_reset_viewports );
+	if ( clip_known ) clip_screen();
+}
 void vdp_set_graphics_viewport( int left, int bottom, int right, int top )
 {
+	clip_set( left + origin_x, bottom + origin_y, right + origin_x, top + origin_y );
 	vdu_set_graphics_viewport.w0 = left;
 	vdu_set_graphics_viewport.w1 = bottom;
 	vdu_set_graphics_viewport.w2 = right;
@@ -228,62 +323,193 @@ static VDU_A_CMD_x_y vdu_circle_radius = { 25, 0x90, 0, 0 };
 static VDU_A_CMD_x_y vdu_circle = { 25, 0x94, 0, 0 };
 static VDU_A_CMD_x_y vdu_filled_rect = { 25, 0x65, 0, 0 };
 
+// Client side clipping of the plot commands
+//
+// - the clip rectangle is the screen (once vdp_get_scr_dims( true ) has read its size) or the
+//   graphics viewport, kept in absolute coordinates so the graphics origin can move
+// - a plot that would draw nothing inside it is dropped, but its point still becomes the graphics
+//   cursor - the last two points are kept here, and sent as moves before the next plot that is
+//   sent, so dropping any run of plots costs at most two moves
+// - moves, and plot types whose extent isn't known from the points (fills, arcs, ellipses,
+//   copies), are always sent
+// - after vdp_clip_invalidate() the VDP's graphics cursor is unknown until absolute points are
+//   plotted, and plots that depend on it are always sent
+
+static void gcur_push( int x, int y )
+{
+	gcur_x[1] = gcur_x[0];
+	gcur_y[1] = gcur_y[0];
+	gcur_x[0] = x;
+	gcur_y[0] = y;
+	if ( gcur_known < 2 ) gcur_known++;
+}
+
+void vdp_clip_enable( bool flag )
+{
+	clip_enabled = flag;
+}
+
+// Something else (fontlibc, vdu.hpp, VDU 5 text) has moved the graphics cursor - the moves of
+// any dropped plots are no longer needed
+
+void vdp_clip_invalidate( void )
+{
+	gcur_stale = 0;
+	gcur_known = 0;
+}
+
+// Send the moves for any dropped plots so the VDP's graphics cursor is up to date
+
+void vdp_clip_sync( void )
+{
+	static VDU_A_CMD_x_y vdu_clip_move = { 25, 0x04, 0, 0 };
+
+	if ( gcur_stale > 1 ) {
+		vdu_clip_move.x = gcur_x[1];
+		vdu_clip_move.y = gcur_y[1];
+		VDP_PUTS( vdu_clip_move );
+	}
+	if ( gcur_stale ) {
+		vdu_clip_move.x = gcur_x[0];
+		vdu_clip_move.y = gcur_y[0];
+		VDP_PUTS( vdu_clip_move );
+	}
+	gcur_stale = 0;
+}
+
+// Grow a bounding box (x0, y0, x1, y1) to include a point
+
+static void extend( int *box, int x, int y )
+{
+	if ( x < box[0] ) box[0] = x;
+	if ( x > box[2] ) box[2] = x;
+	if ( y < box[1] ) box[1] = y;
+	if ( y > box[3] ) box[3] = y;
+}
+
+static void clip_plot( VDU_A_CMD_x_y *cmd )
+{
+	int mode = cmd->CMD;
+	int x = (int16_t)cmd->x, y = (int16_t)cmd->y;
+	int box[4];
+	bool extent = mode & 3;				// not a move
+	uint8_t uses = 0;					// graphics cursor points the extent depends on
+
+	if ( !( mode & 4 ) ) {				// relative
+		if ( !gcur_known ) {			// to a point that isn't known - nor is this one
+			vdp_clip_sync();
+			VDP_PUTS( *cmd );
+			return;
+		}
+		x += gcur_x[0];
+		y += gcur_y[0];
+	}
+	box[0] = box[2] = x;
+	box[1] = box[3] = y;
+
+	if ( extent ) {
+		switch ( mode & 0xF8 ) {
+		case 0x00: case 0x08: case 0x10: case 0x18:			// lines
+		case 0x20: case 0x28: case 0x30: case 0x38:
+		case 0x60:											// rectangle
+			extend( box, gcur_x[0], gcur_y[0] );
+			uses = 1;
+			break;
+		case 0x40:											// point
+			break;
+		case 0x50:											// triangle
+			extend( box, gcur_x[0], gcur_y[0] );
+			extend( box, gcur_x[1], gcur_y[1] );
+			uses = 2;
+			break;
+		case 0x70:											// parallelogram
+			extend( box, gcur_x[0], gcur_y[0] );
+			extend( box, gcur_x[1], gcur_y[1] );
+			extend( box, x - gcur_x[0] + gcur_x[1], y - gcur_y[0] + gcur_y[1] );
+			uses = 2;
+			break;
+		case 0x90: case 0x98: {								// circle, radius to the point
+			int r = abs( x - gcur_x[0] ) + abs( y - gcur_y[0] );
+
+			extend( box, gcur_x[0] - r, gcur_y[0] - r );
+			extend( box, gcur_x[0] + r, gcur_y[0] + r );
+			uses = 1;
+			break;
+		}
+		default:
+			extent = false;
+		}
+	}
+
+	if ( extent && uses <= gcur_known && clip_enabled && clip_known &&
+		 ( box[2] < clip_x0 - origin_x || box[0] > clip_x1 - origin_x ||
+		   box[3] < clip_y0 - origin_y || box[1] > clip_y1 - origin_y ) ) {
+		gcur_push( x, y );
+		if ( gcur_stale < 2 ) gcur_stale++;
+		return;
+	}
+
+	vdp_clip_sync();
+	VDP_PUTS( *cmd );
+	gcur_push( x, y );
+}
+
 // generic plot command - needs plot-mode
 void vdp_plot( int plot_mode, int x, int y )
 {
 	vdu_plot.CMD = plot_mode;
 	vdu_plot.x = x;
 	vdu_plot.y = y;
-	VDP_PUTS( vdu_plot );
+	clip_plot( &vdu_plot );
 }
 
 void vdp_move_to( int x, int y )
 {
 	vdu_move_to.x = x;
 	vdu_move_to.y = y;
-	VDP_PUTS( vdu_move_to );
+	clip_plot( &vdu_move_to );
 }
 
 void vdp_line_to( int x, int y )
 {
 	vdu_line_to.x = x;
 	vdu_line_to.y = y;
-	VDP_PUTS( vdu_line_to );
+	clip_plot( &vdu_line_to );
 }
 
 void vdp_point( int x, int y )
 {
 	vdu_point.x = x;
 	vdu_point.y = y;
-	VDP_PUTS( vdu_point );
+	clip_plot( &vdu_point );
 }
 
 void vdp_triangle( int x, int y )
 {
 	vdu_triangle.x = x;
 	vdu_triangle.y = y;
-	VDP_PUTS( vdu_triangle );
+	clip_plot( &vdu_triangle );
 }
 
 void vdp_circle_radius( int x, int y )
 {
 	vdu_circle_radius.x = x;
 	vdu_circle_radius.y = y;
-	VDP_PUTS( vdu_circle_radius );
+	clip_plot( &vdu_circle_radius );
 }
 
 void vdp_circle( int x, int y )
 {
 	vdu_circle.x = x;
 	vdu_circle.y = y;
-	VDP_PUTS( vdu_circle );
+	clip_plot( &vdu_circle );
 }
 
 void vdp_filled_rect( int x, int y )
 {
 	vdu_filled_rect.x = x;
 	vdu_filled_rect.y = y;
-	VDP_PUTS( vdu_filled_rect );
+	clip_plot( &vdu_filled_rect );
 }
 
 // Bitmaps
@@ -317,18 +543,25 @@ void vdp_load_bitmap( int width, int height, uint32_t *data )
 	int size;
 	char *ptr = (char *)data;
 	for ( size = width*height*sizeof(uint32_t); size > LOAD_BMAP_BLOCK; size -= LOAD_BMAP_BLOCK ) {
-		mos_puts( (char *)ptr, LOAD_BMAP_BLOCK, 0 );
+		vdp_write( ptr, LOAD_BMAP_BLOCK );
 		ptr += LOAD_BMAP_BLOCK;
 	}
-	mos_puts( (char *)ptr, size, 0 );
+	vdp_write( ptr, size );
 }
 
+// Set by vdp_mask_capture to see the pixel data the next loader call sends
+// - called for each block as it's sent, cleared when the loader returns
+
+vdp_load_hook_t vdp_load_hook = NULL;
+
 int vdp_load_bitmap_file( const char *fname, int width, int height )
 {
 	FILE *fp;
 	char *buffer;
 	int exit_code = 0;
+	vdp_load_hook_t hook = vdp_load_hook;
 
+	vdp_load_hook = NULL;
 	if ( !(buffer = (char *)malloc( LOAD_BMAP_BLOCK ) ) ) return -1;
 	if ( !(fp = fopen( fname, "rb" ) ) ) return -1;
 
@@ -338,15 +571,19 @@ int vdp_load_bitmap_file( const char *fname, int width, int height )
 
 	int block_size = LOAD_BMAP_BLOCK;
 	int size = width * height * sizeof(uint32_t);
+	int offset = 0;
 	if ( size < block_size ) block_size = size;
 
 	for ( ; size > block_size; size -= block_size ) {
 		if ( fread( buffer, 1, block_size, fp ) != (size_t)block_size ) exit_code = -1;
-		mos_puts( buffer, block_size, 0 );
+		if ( hook ) hook( 0, width, height, offset, (uint8_t *)buffer, block_size );
+		vdp_write( buffer, block_size );
+		offset += block_size;
 	}
 	if ( size > 0) {
 		if ( fread( buffer, 1, size, fp ) != (size_t)size ) exit_code = -1;
-		mos_puts( buffer, size, 0 );
+		if ( hook ) hook( 0, width, height, offset, (uint8_t *)buffer, size );
+		vdp_write( buffer, size );
 	}
 	fclose( fp );
 	free( buffer );
@@ -389,7 +626,9 @@ int vdp_load_sprite_bitmaps( const char *fname_prefix, const char *fname_format,
 	uint32_t *img_buf;
 	FILE *fp;
 	int cnt = 0;
+	vdp_load_hook_t hook = vdp_load_hook;
 
+	vdp_load_hook = NULL;
 	if ( !(img_buf = (uint32_t *)malloc( width*height*sizeof(uint32_t) ) ) ) return cnt;
 
 	for ( int i = 0; i < num; i++ ) {
@@ -400,6 +639,7 @@ int vdp_load_sprite_bitmaps( const char *fname_prefix, const char *fname_format,
 		fclose( fp );
 		if ( pixel_cnt != (size_t)(width*height) ) return cnt;
 		
+		if ( hook ) hook( i, width, height, 0, (uint8_t *)img_buf, pixel_cnt * sizeof(uint32_t) );
 		vdp_select_bitmap( bitmap_num++ );
 		vdp_load_bitmap( width, height, img_buf );
 		cnt++;
@@ -502,6 +742,9 @@ static VDU_ADV_CMD_ui16 vdu_adv_create       = { 23, 0, 0xA0, 0xFA00, 3, 0};
 static VDU_ADV_CMD      vdu_adv_stream       = { 23, 0, 0xA0, 0xFA00, 4};
 static VDU_ADV_CMD_ui8_ui16 vdu_adv_adjust   = { 23, 0, 0xA0, 0xFA00, 5, 0, 0};
 static VDU_ADV_CMD      vdu_adv_consolidate  = { 23, 0, 0xA0, 0xFA00, 14};
+static VDU_ADV_CMD_ui16 vdu_adv_split        = { 23, 0, 0xA0, 0xFA00, 15, 0};
+static VDU_ADV_CMD_ui16_ui16 vdu_adv_split_from = { 23, 0, 0xA0, 0xFA00, 17, 0, 0};
+static VDU_ADV_CMD_ui16x3 vdu_adv_split_width_from = { 23, 0, 0xA0, 0xFA00, 20, 0, 0, 0};
 
 // VDU 23,27 - extended commands for bufferIds 
 static VDU_A_B_CMD_b	vdu_adv_select_bitmap = { 23, 27, 0x20, 0xFA00};
@@ -550,6 +793,34 @@ void vdp_adv_consolidate(int bufferID)
 	VDP_PUTS(vdu_adv_consolidate);
 }
 
+/* Split a buffer into blocks of blockSize bytes - in place, or into
+ * the buffers targetID, targetID + 1, ... (one block each) */
+void vdp_adv_split(int bufferID, int blockSize)
+{
+	vdu_adv_split.BID = bufferID;
+	vdu_adv_split.ui16 = blockSize;
+	VDP_PUTS(vdu_adv_split);
+}
+
+void vdp_adv_split_from(int bufferID, int blockSize, int targetID)
+{
+	vdu_adv_split_from.BID = bufferID;
+	vdu_adv_split_from.ui16a = blockSize;
+	vdu_adv_split_from.ui16b = targetID;
+	VDP_PUTS(vdu_adv_split_from);
+}
+
+/* Split each row of width bytes into count columns, spread across the
+ * buffers targetID, targetID + 1, ... */
+void vdp_adv_split_width_from(int bufferID, int width, int count, int targetID)
+{
+	vdu_adv_split_width_from.BID = bufferID;
+	vdu_adv_split_width_from.ui16a = width;
+	vdu_adv_split_width_from.ui16b = count;
+	vdu_adv_split_width_from.ui16c = targetID;
+	VDP_PUTS(vdu_adv_split_width_from);
+}
+
 void vdp_adv_select_bitmap(int bufferID)
 {
 	vdu_adv_select_bitmap.b = bufferID;
@@ -759,10 +1030,10 @@ void vdp_audio_load_sample( int sample, int length, uint8_t *data)
 	int size;
 	char *ptr = (char *)data;
 	for ( size = length; size > LOAD_BMAP_BLOCK; size -= LOAD_BMAP_BLOCK ) {
-		mos_puts( (char *)ptr, LOAD_BMAP_BLOCK, 0 );
+		vdp_write( ptr, LOAD_BMAP_BLOCK );
 		ptr += LOAD_BMAP_BLOCK;
 	}
-	mos_puts( (char *)ptr, size, 0 );
+	vdp_write( ptr, size );
 }
 
 // 	Command 5, 1: Clear sample
@@ -31,6 +31,7 @@ int fclose(FILE *stream)
 
     mos_fh = stream->fhandle;
     if ( mos_fh == FH_STDIN || mos_fh == FH_STDOUT || mos_fh == FH_STDERR ) return EOF;
+    if ( mos_fh == FH_DEVICE ) return 0;            // Device stays open - closed by its driver
 
     _file_streams[mos_fh - 1].fhandle = 0;
 
@@ -19,6 +19,11 @@ Return Value
 #include <stdio.h>
 #include <mos_api.h>
 
+extern int (*_stdio_dev_getc)( void );
+extern int _stdin_getc(void);
+
+static FILE *_dev_cr_stream;                           // Device stream whose last character read was a CR
+
 int fgetc(FILE *stream)
 {
     int c;
@@ -26,16 +31,30 @@ int fgetc(FILE *stream)
 
     if (stream == NULL || stream == stdout || stream == stderr) c = EOF;
     else if ( (c = stream->unget_char) ) stream->unget_char = 0;
-    else if (mos_fh == FH_STDIN) {
-        c = inchar();
-        putchar(c);
-        if ( c == '\r' ) { c = '\n'; putchar(c); }
+    else if (stream == stdin) {
+        c = _stdin_getc();                              // Line buffered - see stdin.c
+        if (c == EOF) stream->eof = 1;
+        return c;
+    }
+    else if (mos_fh == FH_DEVICE) {
+        c = _stdio_dev_getc ? _stdio_dev_getc() : EOF;     // Devices can return zero bytes
+        if ( _dev_cr_stream == stream && c != EOF ) {    // The LF of a CR/LF already returned as '\n'
+            _dev_cr_stream = NULL;
+            if ( c == '\n' ) c = _stdio_dev_getc();
+        }
+        if ( stream->text_mode && c == '\r' ) {          // CR/LF, or CR alone as terminals send for Enter -
+            _dev_cr_stream = stream;                    // don't wait for an LF that may never come
+            return '\n';
+        }
+        if ( c == EOF ) stream->eof = 1;
+        return c;
     }
     else {
         c = mos_fgetc(stream->fhandle);
         if ( stream->text_mode && c == '\r' ) {         // Do CR/LF translation for text files
-            c = mos_fgetc(stream->fhandle);
-            if ( c != '\n' ) ungetc( c, stream );       // Put back if just CR and not CR/LF
+            int next = mos_fgetc(stream->fhandle);
+            if ( next == '\n' ) c = '\n';
+            else if ( next ) ungetc( next, stream );    // Put back if just CR and not CR/LF
         }
     }
 
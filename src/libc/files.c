@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // Allocate space for storage of the MOS file stream IDs and the status
 
@@ -15,6 +16,12 @@ FILE stdin[1]  = {{ FH_STDIN, 0, 0, FH_TEXT, 0 }};
 FILE stdout[1] = {{ FH_STDOUT, 0, 0, FH_TEXT, 0 }};
 FILE stderr[1] = {{ FH_STDERR, 0, 0, FH_TEXT, 0 }};
 
+// Character device hooks for FH_DEVICE streams (e.g. the UART1 driver's ser_fopen)
+// - only one device stream can be active at a time
+
+int (*_stdio_dev_getc)( void ) = NULL;
+int (*_stdio_dev_putc)( int c ) = NULL;
+
 // The following initialistion is called from crt0.src to re-initialise stdin, stdout, stderr
 // - this is necessary in case these have been redirected and the program is re-run
 
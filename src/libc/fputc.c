@@ -24,6 +24,8 @@ Return Value
 
 void fput_char( int c, FILE *stream );
 
+extern int (*_stdio_dev_putc)( int c );
+
 int fputc(int c, FILE *stream)
 {
     int ret = c;
@@ -47,5 +49,8 @@ void fput_char( int c, FILE *stream )
     uint8_t mos_fh = stream->fhandle;
 
     if ( mos_fh == FH_STDOUT || mos_fh == FH_STDERR ) outchar(c);
+    else if ( mos_fh == FH_DEVICE ) {
+        if ( !_stdio_dev_putc || _stdio_dev_putc(c) == EOF ) stream->err = 1;
+    }
     else mos_fputc(stream->fhandle, (char)c );         // The mos routine does not return anything
 }
\ No newline at end of file
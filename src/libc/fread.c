@@ -22,6 +22,8 @@ Return Value
 #include <stdio.h>
 #include <mos_api.h>
 
+extern size_t _stdin_read(char *ptr, size_t len);
+
 size_t fread(void *ptr, size_t size, size_t count, FILE *__restrict stream)
 {
     size_t nbytes;
@@ -29,9 +31,27 @@ size_t fread(void *ptr, size_t size, size_t count, FILE *__restrict stream)
 
     if (stream == NULL || stream == stdout || stream == stderr) return 0;
 
-    // For stdin read characters one by one using fgetc upto size*count characters
+    // For stdin copy from the line buffer (see stdin.c)
 
     if (stream == stdin)
+    {
+        char *p = (char *)ptr;
+
+        nbytes = 0;
+        if (len && stream->unget_char)
+        {
+            *p++ = stream->unget_char;
+            stream->unget_char = 0;
+            nbytes++;
+        }
+        nbytes += _stdin_read(p, len - nbytes);
+        if (nbytes != len) stream->eof = 1;
+        return nbytes / size;
+    }
+
+    // For devices read characters one by one using fgetc upto size*count characters
+
+    if (stream->fhandle == FH_DEVICE)
     {
         int c;
         char *p = (char *)ptr;
@@ -25,6 +25,8 @@ Return Value
 #include <stdio.h>
 #include <mos_api.h>
 
+extern void _stdin_discard(void);
+
 FILE *freopen( const char *__restrict filename, const char *__restrict mode, FILE *stream )
 {
     FILE *fp;
@@ -39,5 +41,6 @@ FILE *freopen( const char *__restrict filename, const char *__restrict mode, FIL
     if ( !( fp = fopen( filename, mode ) ) ) return NULL;
 
     *stream = *fp;
+    if (stream == stdin) _stdin_discard();          // Drop anything read ahead from the old stdin
     return stream;
 }
\ No newline at end of file
@@ -34,6 +34,9 @@ Return Value
 #include <mos_api.h>
 #include <errno.h>
 
+extern size_t _stdin_buffered(void);
+extern void _stdin_discard(void);
+
 int fseek(FILE *stream, long int offset, int origin)
 {
     if (stream == NULL || stream->fhandle >= FH_STDIN )
@@ -51,6 +54,7 @@ int fseek(FILE *stream, long int offset, int origin)
             break;
         case SEEK_CUR:
             offset += (long)(file_struct->fptr);
+            if (stream == stdin) offset -= _stdin_buffered();   // Characters read ahead
             break;
         case SEEK_END:
             offset += (long)(file_struct->obj.objsize);
@@ -59,5 +63,6 @@ int fseek(FILE *stream, long int offset, int origin)
             errno = EINVAL;
             return -1;
     }
+    if (stream == stdin) _stdin_discard();
     return mos_flseek( stream->fhandle, offset );
 }
@@ -26,6 +26,8 @@ Return Value
 #include <errno.h>
 #include <mos_api.h>
 
+extern size_t _stdin_buffered(void);
+
 long int ftell(FILE *stream)
 {
     if (stream == NULL || stream->fhandle >= FH_STDIN)
@@ -36,5 +38,6 @@ long int ftell(FILE *stream)
 
     FIL *file_struct = mos_getfil( stream->fhandle );
 
+    if (stream == stdin) return (long)(file_struct->fptr) - _stdin_buffered();
     return (long)(file_struct->fptr);
 }
@@ -42,6 +42,19 @@ size_t fwrite(const void *__restrict ptr, size_t size, size_t count, FILE *__res
         return nbytes / size;
     }
 
+    // For devices write characters one by one using fputc
+
+    if (stream->fhandle == FH_DEVICE)
+    {
+        const char *p = (const char *)ptr;
+
+        for ( nbytes = 0; nbytes < len; nbytes++ )
+        {
+            if (fputc(*p++, stream) == EOF || stream->err) break;
+        }
+        return nbytes / size;
+    }
+
     // For regular file use mos_fwrite
 
     nbytes = mos_fwrite( stream->fhandle, (char *)ptr, len );
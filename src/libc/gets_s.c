@@ -4,7 +4,7 @@
 Paul Cawte 13/06/2023
 
 Reads characters from console until a newline is found or end-of-file occurs.
-End of line is translated to LF in getchar()
+End of line is translated to LF in the stdin line buffer (stdin.c)
 Writes only at most n-1 characters into the array pointed to by str, 
 and always writes the terminating null character (unless str is a null pointer).
 The LF character, if found, is discarded and does not count toward the number of characters
@@ -31,6 +31,8 @@ str on success, a null pointer on failure.
 
 Updates:
 26/07/2023 - added handling for backspace, cursor left and control-C
+18/10/2026 - console input is line buffered with mos_editline (see stdin.c), which now does the
+             editing, so backspace / control-C handling is removed here
 
 */
 
@@ -38,8 +40,6 @@ Updates:
 #include <string.h>
 #include <stdlib.h>
 
-#define BS_KEY '\x7f'
-
 
 char *gets_s( char *__restrict str, rsize_t n )
 {
@@ -58,16 +58,10 @@ char *gets_s( char *__restrict str, rsize_t n )
 	}
 
 	c = getchar();
-	while ( c != '\n' )								// Keep collecting input until end of line
+	while ( c != '\n' && c != EOF )				// Keep collecting input until end of line
 	{
-	    if ( c == '\x03' ) exit( EXIT_FAILURE );    // Exit if control C is pressed
-	    if ( c == BS_KEY || c == '\b' ) {
-	    	if ( cnt > 0 ) { cnt--; s--; }
-	    	if ( c == '\b' ) { putchar(' '); putchar(BS_KEY); }
-	    } else {
-			if ( cnt < n ) *s++ = c;				// Store characters if not reached end of buffer
-			cnt++;
-		}
+		if ( cnt < n ) *s++ = c;					// Store characters if not reached end of buffer
+		cnt++;
 		c = getchar();
 	}
 	if ( cnt >= n ) return( NULL );					// Return error if no. of characters received > max -1
@@ -0,0 +1,84 @@
+#ifndef _BITOPS_H
+#define _BITOPS_H
+
+#include <cdefs.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+__BEGIN_DECLS
+
+/* Bit operations on 8, 24 and 32-bit values
+ *
+ * The counts call hand written eZ80 routines in the crt (clz.src, ctz.src, popcount.src,
+ * bswap.src), which skip zero bytes whole and use a nibble table for the last byte, rather than
+ * the bit at a time loops the compiler builtins expand to.
+ * - clz / ctz of 0 return the width of the type
+ * - ffs / fls return the 1-based index of the lowest / highest set bit, or 0 for 0
+ */
+
+int __clzsi2(uint32_t x);
+int __clzpsi2(uint24_t x);
+int __ctzsi2(uint32_t x);
+int __ctzpsi2(uint24_t x);
+int __popcountsi2(uint32_t x);
+int __popcountpsi2(uint24_t x);
+uint32_t __bswapsi2(uint32_t x);
+uint24_t __bswappsi2(uint24_t x);
+
+static inline uint8_t bit_popcount8(uint8_t x)   { return __popcountpsi2(x); }
+static inline uint8_t bit_popcount24(uint24_t x) { return __popcountpsi2(x); }
+static inline uint8_t bit_popcount32(uint32_t x) { return __popcountsi2(x); }
+
+static inline uint8_t bit_clz8(uint8_t x)        { return __clzpsi2(x) - 16; }
+static inline uint8_t bit_clz24(uint24_t x)      { return __clzpsi2(x); }
+static inline uint8_t bit_clz32(uint32_t x)      { return __clzsi2(x); }
+
+static inline uint8_t bit_ctz8(uint8_t x)        { return x ? __ctzpsi2(x) : 8; }
+static inline uint8_t bit_ctz24(uint24_t x)      { return __ctzpsi2(x); }
+static inline uint8_t bit_ctz32(uint32_t x)      { return __ctzsi2(x); }
+
+static inline uint8_t bit_ffs8(uint8_t x)        { return x ? __ctzpsi2(x) + 1 : 0; }
+static inline uint8_t bit_ffs24(uint24_t x)      { return x ? __ctzpsi2(x) + 1 : 0; }
+static inline uint8_t bit_ffs32(uint32_t x)      { return x ? __ctzsi2(x) + 1 : 0; }
+
+static inline uint8_t bit_fls8(uint8_t x)        { return 24 - __clzpsi2(x); }
+static inline uint8_t bit_fls24(uint24_t x)      { return 24 - __clzpsi2(x); }
+static inline uint8_t bit_fls32(uint32_t x)      { return 32 - __clzsi2(x); }
+
+static inline uint16_t bit_bswap16(uint16_t x)   { return (uint16_t)(x << 8 | x >> 8); }
+static inline uint24_t bit_bswap24(uint24_t x)   { return __bswappsi2(x); }
+static inline uint32_t bit_bswap32(uint32_t x)   { return __bswapsi2(x); }
+
+/* Bitmaps stored as byte arrays, bit n is bit (n & 7) of byte n >> 3 */
+
+static inline bool bitmap_test(const uint8_t *map, uint24_t n) { return map[n >> 3] & (1 << (n & 7)); }
+static inline void bitmap_set(uint8_t *map, uint24_t n)        { map[n >> 3] |= 1 << (n & 7); }
+static inline void bitmap_clear(uint8_t *map, uint24_t n)      { map[n >> 3] &= ~(1 << (n & 7)); }
+
+/* Index of the first set (or clear) bit in a map of nbytes bytes, or -1 if there is none */
+
+static inline int24_t bitmap_find_set(const uint8_t *map, uint24_t nbytes)
+{
+    uint24_t i;
+
+    for (i = 0; i < nbytes; i++)
+    {
+        if (map[i]) return (int24_t)(i << 3) + __ctzpsi2(map[i]);
+    }
+    return -1;
+}
+
+static inline int24_t bitmap_find_clear(const uint8_t *map, uint24_t nbytes)
+{
+    uint24_t i;
+
+    for (i = 0; i < nbytes; i++)
+    {
+        if (map[i] != 0xFF) return (int24_t)(i << 3) + __ctzpsi2((uint8_t)~map[i]);
+    }
+    return -1;
+}
+
+__END_DECLS
+
+#endif
@@ -3,6 +3,13 @@
  * @brief Provides improved font support.
  *
  * @author DrDnar
+ *
+ * Agon port: glyphs are uploaded once to the VDP as 1-bit bitmaps held in
+ * buffers (see fontlib_SetBitmapBase) when a font is selected, and strings are
+ * drawn as a single stream of bitmap plots rather than pixel by pixel.
+ * Coordinates are screen pixels, so call vdp_logical_scr_dims( false ) first.
+ * Colors are palette indices, applied with GCOL when drawing.  Font packs are
+ * files on the SD card rather than appvars.
  */
 
 #ifndef _FONTLIBC_H
@@ -314,7 +321,7 @@ void fontlib_SetWindowFullScreen(void);
  * @param[in] width Width
  * @param[in] height Height
  */
-void fontlib_SetWindow(unsigned int x_min, uint8_t y_min, unsigned int width, uint8_t height);
+void fontlib_SetWindow(unsigned int x_min, unsigned int y_min, unsigned int width, unsigned int height);
 
 /**
  * Returns the starting column of the current text window
@@ -326,7 +333,7 @@ unsigned int fontlib_GetWindowXMin(void);
  * Returns the starting row of the current text window
  * @return Window Y
  */
-uint8_t fontlib_GetWindowYMin(void);
+unsigned int fontlib_GetWindowYMin(void);
 
 /**
  * Returns the width of the current text window
@@ -338,7 +345,7 @@ unsigned int fontlib_GetWindowWidth(void);
  * Returns the height of the current text window
  * @return Window height
  */
-uint8_t fontlib_GetWindowHeight(void);
+unsigned int fontlib_GetWindowHeight(void);
 
 /**
  * Sets the cursor position.
@@ -347,7 +354,7 @@ uint8_t fontlib_GetWindowHeight(void);
  * @param[in] x X
  * @param[in] y Y
  */
-void fontlib_SetCursorPosition(unsigned int x, uint8_t y);
+void fontlib_SetCursorPosition(unsigned int x, unsigned int y);
 
 /**
  * Returns the cursor column.
@@ -359,7 +366,7 @@ unsigned int fontlib_GetCursorX(void);
  * Returns the cursor row.
  * @return Current cursor Y
  */
-uint8_t fontlib_GetCursorY(void);
+unsigned int fontlib_GetCursorY(void);
 
 /**
  * Adds the given (x,y) to the cursor position.
@@ -373,12 +380,12 @@ void fontlib_ShiftCursorPosition(int x, int y);
 /**
  * Moves the cursor to the upper left corner of the text window.
  */
-void fontlib_HomeUp();
+void fontlib_HomeUp(void);
 
 /**
  * Moves the cursor back to the start of the current line.
  */
-void fontlib_Home();
+void fontlib_Home(void);
 
 /**
  * Sets the current font
@@ -821,6 +828,73 @@ fontlib_font_t *fontlib_GetFontByIndex(const char *font_pack_name, uint8_t index
 fontlib_font_t *fontlib_GetFontByStyle(const char *font_pack_name, uint8_t size_min, uint8_t size_max, uint8_t weight_min, uint8_t weight_max, uint8_t style_bits_set, uint8_t style_bits_reset);
 
 
+
+/**
+ * A kerning pair: the horizontal adjustment applied between two glyphs.
+ * @see fontlib_SetKerning
+ */
+typedef struct fontlib_kern_pair_t {
+    /**
+     * Code point of the left glyph.
+     */
+    uint8_t left;
+    /**
+     * Code point of the right glyph.
+     */
+    uint8_t right;
+    /**
+     * Pixels to add to the advance of the left glyph (usually negative).
+     */
+    int8_t adjust;
+} fontlib_kern_pair_t;
+
+/**
+ * Number of string cache slots available to fontlib_CacheString.
+ */
+#define FONTLIB_CACHE_SLOTS 32
+
+/**
+ * Sets the first of the VDP buffer IDs used by the library (Agon only).
+ * Glyph bitmaps use base + code point; cached strings use base + 256 + slot.
+ * Defaults to 0xF800.  Call before fontlib_SetFont.
+ * @param[in] buffer_id First VDP buffer ID to use
+ */
+void fontlib_SetBitmapBase(uint16_t buffer_id);
+
+/**
+ * Sets the kerning table used by the string functions (Agon only).
+ * @param[in] pairs Kerning pairs sorted by left then right code point, or NULL
+ * @param[in] count Number of pairs
+ * @note The table is not copied and must stay valid while in use.
+ */
+void fontlib_SetKerning(const fontlib_kern_pair_t *pairs, size_t count);
+
+/**
+ * Records the plot commands for a string into a VDP buffer (Agon only), so
+ * that it can be redrawn with a single call.  Newlines and window bounds are
+ * not processed.
+ * @param[in] slot Cache slot, 0 to FONTLIB_CACHE_SLOTS - 1
+ * @param[in] str Pointer to string
+ * @return Width of the cached string in pixels
+ * @note Cached strings keep the glyphs of the font current when they were
+ * made; re-cache them after fontlib_SetFont.
+ */
+unsigned int fontlib_CacheString(uint8_t slot, const char *str);
+
+/**
+ * Draws a string previously recorded with fontlib_CacheString at the cursor
+ * position in the current colors (Agon only).
+ * @param[in] slot Cache slot
+ * @return The new X value of the cursor
+ */
+uint24_t fontlib_DrawCachedString(uint8_t slot);
+
+/**
+ * Releases the VDP buffer held by a cache slot (Agon only).
+ * @param[in] slot Cache slot
+ */
+void fontlib_FreeCachedString(uint8_t slot);
+
 #ifdef __cplusplus
 }
 #endif
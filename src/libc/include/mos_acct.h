@@ -0,0 +1,66 @@
+#ifndef _MOS_ACCT_H
+#define _MOS_ACCT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MOS call accounting
+//
+// "make mos-acct" builds the program with MOS_ACCOUNTING set, so the mos_api.src routines below
+// and outchar count each call and the time spent in the MOS trap (rst.lil 08h / 10h / 18h),
+// using TMR1.
+// When the program exits the totals are written to MOS_ACCT_FILE, or they can be read or printed
+// at any time, e.g. around one frame or one file load.
+//
+// - ticks are 256 system clocks (about 13.9us), a single call of over 0.9s is under counted
+// - getsysvar_* are reads of the sysvars (no trap), so only their count is kept, for code
+//   compiled with MOS_ACCOUNTING
+// - in a normal build the functions below are available but all the counts stay 0
+
+#define MOS_ACCT_FILE		"mosacct.txt"
+
+enum {
+	MOS_ACCT_PUTCH,
+	MOS_ACCT_GETCH,
+	MOS_ACCT_PUTS,
+	MOS_ACCT_FOPEN,
+	MOS_ACCT_FCLOSE,
+	MOS_ACCT_FGETC,
+	MOS_ACCT_FPUTC,
+	MOS_ACCT_FEOF,
+	MOS_ACCT_FREAD,
+	MOS_ACCT_FWRITE,
+	MOS_ACCT_FLSEEK,
+	MOS_ACCT_GETFIL,
+	MOS_ACCT_OUTCHAR,			// putchar, printf etc. (outchar.src)
+	MOS_ACCT_SYSVARS,
+	MOS_ACCT_SLOTS
+};
+
+typedef struct {
+	uint24_t count;
+	uint32_t ticks;
+} MOS_ACCT;
+
+#define MOS_ACCT_TICKS_TO_US(T)	((uint32_t)(T) / 9 * 125 + (uint32_t)(T) % 9 * 125 / 9)
+
+// Copy the totals for all MOS_ACCT_SLOTS into acct
+void mos_acct_read( MOS_ACCT *acct );
+// Clear the totals
+void mos_acct_reset( void );
+const char *mos_acct_name( uint8_t slot );
+// Print the totals (calls, ticks, microseconds per call) with printf
+void mos_acct_print( void );
+// Stop counting and write the totals to MOS_ACCT_FILE (registered with atexit by the first call)
+void mos_acct_dump( void );
+// Stop counting and release TMR1
+void mos_acct_stop( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
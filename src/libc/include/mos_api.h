@@ -15,6 +15,7 @@
  * 22/07/2023:      Added structure for SYSVAR
  * 18/11/2023:		Added mos_setkbvector, mos_getkbmap, mos_i2c_open, mos_i2c_close, mos_i2c_write, mos_i2c_read
  * 05/04/2024:		Added more mos sysvars, and expanded SYSVAR struct
+ * 18/10/2026:		getsysvar_* are now inline reads through _agdev_sysvars (cached by crt0)
  */
 
 #ifndef _MOS_H
@@ -214,29 +215,49 @@ extern void  waitvblank(void);
 extern void  mos_puts(char * buffer, uint24_t size, char delimiter);
 
 // Get system variables
-extern uint32_t getsysvar_time();
-extern uint8_t  getsysvar_vpd_pflags();
-extern uint8_t  getsysvar_keyascii();
-extern uint8_t  getsysvar_keymods();
-extern uint8_t  getsysvar_cursorX();
-extern uint8_t  getsysvar_cursorY();
-extern uint8_t  getsysvar_scrchar();
-extern uint24_t getsysvar_scrpixel();
-extern uint8_t  getsysvar_audioChannel();
-extern uint8_t  getsysvar_audioSuccess();
-extern uint16_t getsysvar_scrwidth();
-extern uint16_t getsysvar_scrheight();
-extern uint8_t  getsysvar_scrCols();
-extern uint8_t  getsysvar_scrRows();
-extern uint8_t  getsysvar_scrColours();
-extern uint8_t  getsysvar_scrpixelIndex();
-extern uint8_t  getsysvar_vkeycode();
-extern uint8_t  getsysvar_vkeydown();
-extern uint8_t  getsysvar_vkeycount();
-extern volatile RTC_DATA* getsysvar_rtc();  // mos_getrtc() needs to be called to update the values
-extern uint16_t getsysvar_keydelay();
-extern uint16_t getsysvar_keyrate();
-extern uint8_t  getsysvar_keyled();
+// - the SYSVAR pointer is cached by crt0 at startup, so these are simple loads rather than MOS calls
+// - the assembler versions in mos_api.src remain for use from assembly code
+
+extern volatile SYSVAR *_agdev_sysvars;
+
+// MOS call accounting builds (make mos-acct, see mos_acct.h) count the getsysvar_* reads
+#ifdef MOS_ACCOUNTING
+extern uint24_t _mos_acct_sysvars;
+#define _MOS_SYSVARS (_mos_acct_sysvars++, _agdev_sysvars)
+#else
+#define _MOS_SYSVARS _agdev_sysvars
+#endif
+
+// time is updated by the VBLANK interrupt, so re-read if the low byte changed part way through
+// (every update adds 2, so the low byte always changes)
+static inline uint32_t getsysvar_time(void) {
+	volatile SYSVAR *sv = _MOS_SYSVARS;
+	uint32_t t;
+	do t = sv->time; while ( (uint8_t)t != *(volatile uint8_t *)&sv->time );
+	return t;
+}
+static inline uint8_t  getsysvar_vpd_pflags(void)    { return _MOS_SYSVARS->vpd_pflags; }
+static inline uint8_t  getsysvar_keyascii(void)      { return _MOS_SYSVARS->keyascii; }
+static inline uint8_t  getsysvar_keymods(void)       { return _MOS_SYSVARS->keymods; }
+static inline uint8_t  getsysvar_cursorX(void)       { return _MOS_SYSVARS->cursorX; }
+static inline uint8_t  getsysvar_cursorY(void)       { return _MOS_SYSVARS->cursorY; }
+static inline uint8_t  getsysvar_scrchar(void)       { return _MOS_SYSVARS->scrchar; }
+static inline uint24_t getsysvar_scrpixel(void)      { return _MOS_SYSVARS->scrpixel; }
+static inline uint8_t  getsysvar_audioChannel(void)  { return _MOS_SYSVARS->audioChannel; }
+static inline uint8_t  getsysvar_audioSuccess(void)  { return _MOS_SYSVARS->audioSuccess; }
+static inline uint16_t getsysvar_scrwidth(void)      { return _MOS_SYSVARS->scrWidth; }
+static inline uint16_t getsysvar_scrheight(void)     { return _MOS_SYSVARS->scrHeight; }
+static inline uint8_t  getsysvar_scrCols(void)       { return _MOS_SYSVARS->scrCols; }
+static inline uint8_t  getsysvar_scrRows(void)       { return _MOS_SYSVARS->scrRows; }
+static inline uint8_t  getsysvar_scrColours(void)    { return _MOS_SYSVARS->scrColours; }
+static inline uint8_t  getsysvar_scrpixelIndex(void) { return _MOS_SYSVARS->scrpixelIndex; }
+static inline uint8_t  getsysvar_vkeycode(void)      { return _MOS_SYSVARS->vkeycode; }
+static inline uint8_t  getsysvar_vkeydown(void)      { return _MOS_SYSVARS->vkeydown; }
+static inline uint8_t  getsysvar_vkeycount(void)     { return _MOS_SYSVARS->vkeycount; }
+static inline volatile RTC_DATA *getsysvar_rtc(void) { return &_MOS_SYSVARS->rtc; }  // mos_getrtc() needs to be called to update the values
+static inline uint16_t getsysvar_keydelay(void)      { return _MOS_SYSVARS->keydelay; }
+static inline uint16_t getsysvar_keyrate(void)       { return _MOS_SYSVARS->keyrate; }
+static inline uint8_t  getsysvar_keyled(void)        { return _MOS_SYSVARS->keyled; }
 
 // MOS API calls
 extern uint8_t  mos_load(const char *filename, uint24_t address, uint24_t maxsize);
@@ -19,6 +19,7 @@ typedef struct
 #define FH_STDIN 128                    // This is the minimum can check if not real file
 #define FH_STDOUT 129                   // by >= FH_STDIN
 #define FH_STDERR 130
+#define FH_DEVICE 131                   // Character device - see _stdio_dev_getc / _stdio_dev_putc
 
 /* Original CE Toolchain definitions are not real pointers - but are assinged to
 #define stdin  ((FILE*)1)
@@ -46,6 +46,22 @@ human readable time information (see details in the struct definition below.
 
 typedef unsigned long time_t;
 typedef unsigned long clock_t;
+typedef int clockid_t;
+
+// Time with sub-second resolution - on Agon the resolution is 1 centisecond
+
+struct timespec {
+   time_t tv_sec;       // seconds
+   long tv_nsec;        // nanoseconds
+};
+
+struct timeval {
+   time_t tv_sec;       // seconds
+   long tv_usec;        // microseconds
+};
+
+#define CLOCK_REALTIME  0   // time since the epoch (cached RTC, see time_resync)
+#define CLOCK_MONOTONIC 1   // time since MOS started
 
 struct tm {
    int tm_sec;          // normally 0-59, can be 60 for leap-second
@@ -70,6 +86,12 @@ time_t mktime(struct tm *tmp);
 
 time_t time(time_t *timer);
 
+int gettimeofday(struct timeval *tv, void *tz);
+
+int clock_gettime(clockid_t clk_id, struct timespec *tp);
+
+void time_resync(void);         // re-read the RTC now (otherwise done every 10 minutes)
+
 struct tm *localtime(const time_t *timer);
 
 struct tm *gmtime(const time_t *timer);
@@ -64,7 +64,7 @@ time_t mktime(struct tm *tp)
     }
 
     days += dpmt[tp->tm_mon];
-    if (__isleap(tp->tm_year))
+    if (tp->tm_mon > 1 && __isleap(tp->tm_year + 1900))
     {
         days++;
     }
@@ -0,0 +1,102 @@
+/* MOS call accounting for make mos-acct
+   -------------------------------------
+
+Programs built with "make mos-acct" are linked with MOS_ACCOUNTING set, so the accounted
+mos_api.src routines and outchar call __mos_acct_08h / 10h / 18h (mos_acct.src) in place of the
+MOS trap. These add to the count and TMR1 ticks in _mos_acct_table for the routine's slot. The first call
+registers mos_acct_dump() with atexit, which writes a table to MOS_ACCT_FILE:
+
+    name      calls      ticks      us/call
+
+The getsysvar_* inlines in mos_api.h add to _mos_acct_sysvars instead, as they make no trap.
+
+See mos_acct.h for the slots and the API.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <mos_api.h>
+#include <mos_acct.h>
+
+MOS_ACCT _mos_acct_table[MOS_ACCT_SLOTS];
+uint24_t _mos_acct_sysvars = 0;
+uint8_t _mos_acct_state = 0;            // 0: not started, 1: counting, 2: stopped
+
+static const char *const acct_names[MOS_ACCT_SLOTS] = {
+    "putch", "getch", "puts", "fopen", "fclose", "fgetc", "fputc",
+    "feof", "fread", "fwrite", "flseek", "getfil", "outchar", "getsysvar"
+};
+
+void mos_acct_read(MOS_ACCT *acct)
+{
+    memcpy(acct, _mos_acct_table, sizeof(_mos_acct_table));
+    acct[MOS_ACCT_SYSVARS].count = _mos_acct_sysvars;
+    acct[MOS_ACCT_SYSVARS].ticks = 0;
+}
+
+void mos_acct_reset(void)
+{
+    memset(_mos_acct_table, 0, sizeof(_mos_acct_table));
+    _mos_acct_sysvars = 0;
+}
+
+const char *mos_acct_name(uint8_t slot)
+{
+    return slot < MOS_ACCT_SLOTS ? acct_names[slot] : "";
+}
+
+// Format one line of the table, skipping slots with no calls - returns the length or 0
+
+static int acct_line(char *buf, size_t len, const MOS_ACCT *acct, uint8_t slot)
+{
+    const MOS_ACCT *a = &acct[slot];
+
+    if (!a->count) return 0;
+    if (slot == MOS_ACCT_SYSVARS)
+    {
+        return snprintf(buf, len, "%-10s %8u %10s %8s\r\n", acct_names[slot], a->count, "-", "-");
+    }
+    return snprintf(buf, len, "%-10s %8u %10lu %8lu\r\n", acct_names[slot], a->count, a->ticks,
+                    MOS_ACCT_TICKS_TO_US(a->ticks) / a->count);
+}
+
+void mos_acct_print(void)
+{
+    MOS_ACCT acct[MOS_ACCT_SLOTS];
+    char line[48];
+    uint8_t slot;
+
+    // Take a copy first, as printing makes more calls
+
+    mos_acct_read(acct);
+    printf("%-10s %8s %10s %8s\r\n", "name", "calls", "ticks", "us/call");
+    for (slot = 0; slot < MOS_ACCT_SLOTS; slot++)
+    {
+        if (acct_line(line, sizeof(line), acct, slot)) fputs(line, stdout);
+    }
+}
+
+void mos_acct_dump(void)
+{
+    MOS_ACCT acct[MOS_ACCT_SLOTS];
+    char line[48];
+    uint8_t slot;
+    uint8_t fh;
+    int len;
+
+    mos_acct_stop();
+    mos_acct_read(acct);
+
+    fh = mos_fopen(MOS_ACCT_FILE, FA_WRITE | FA_CREATE_ALWAYS);
+    if (!fh) return;
+
+    len = snprintf(line, sizeof(line), "%-10s %8s %10s %8s\r\n", "name", "calls", "ticks", "us/call");
+    mos_fwrite(fh, line, len);
+    for (slot = 0; slot < MOS_ACCT_SLOTS; slot++)
+    {
+        len = acct_line(line, sizeof(line), acct, slot);
+        if (len) mos_fwrite(fh, line, len);
+    }
+    mos_fclose(fh);
+}
@@ -37,6 +37,11 @@
 
 #define NANOPRINTF_IMPLEMENTATION
 
+// snprintf always terminates the string, cutting it short if needed, as the C standard requires
+#if !defined(NANOPRINTF_SNPRINTF_SAFE_EMPTY_STRING_ON_OVERFLOW)
+  #define NANOPRINTF_SNPRINTF_SAFE_TRIM_STRING_ON_OVERFLOW
+#endif
+
 #ifdef NANOPRINTF_IMPLEMENTATION
 
 #ifndef NANOPRINTF_IMPLEMENTATION_INCLUDED
@@ -683,6 +688,7 @@ int npf_vpprintf(npf_putc pc, void *pc_ctx, char const *format, va_list args) {
       if (fs.field_width < 0) {
         fs.field_width = -fs.field_width;
         fs.left_justified = 1;
+        fs.leading_zero_pad = 0;  // '-' overrides '0', as when both are flags
       }
     }
 #endif
@@ -875,7 +881,9 @@ int npf_vpprintf(npf_putc pc, void *pc_ctx, char const *format, va_list args) {
             (fs.conv_spec != NPF_FMT_SPEC_CONV_CHAR) &&
             (fs.conv_spec != NPF_FMT_SPEC_CONV_PERCENT)) {
 #if NANOPRINTF_USE_PRECISION_FORMAT_SPECIFIERS == 1
-          if ((fs.prec_opt == NPF_FMT_SPEC_OPT_LITERAL) && !fs.prec && zero) {
+          // '0' is ignored when an integer conversion has a precision, as C requires
+          if ((fs.prec_opt == NPF_FMT_SPEC_OPT_LITERAL) &&
+              ((fs.conv_spec <= NPF_FMT_SPEC_CONV_UNSIGNED_INT) || (!fs.prec && zero))) {
             pad_c = ' ';
           } else
 #endif
@@ -1014,9 +1022,9 @@ int vsnprintf(char *buffer, size_t bufsz, char const *format, va_list vlist) {
   pc('\0', &bufputc_ctx);
 
 #ifdef NANOPRINTF_SNPRINTF_SAFE_EMPTY_STRING_ON_OVERFLOW
-  if (bufsz && (n >= (int)bufsz)) { buffer[0] = '\0'; }
+  if (bufsz && (n >= 0) && ((size_t)n >= bufsz)) { buffer[0] = '\0'; }
 #elif defined(NANOPRINTF_SNPRINTF_SAFE_TRIM_STRING_ON_OVERFLOW)
-  if (bufsz && (n >= (int)bufsz)) { buffer[bufsz - 1] = '\0'; }
+  if (bufsz && (n >= 0) && ((size_t)n >= bufsz)) { buffer[bufsz - 1] = '\0'; }
 #endif
 
   return n;
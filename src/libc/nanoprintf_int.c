@@ -0,0 +1,15 @@
+/*
+  nanoprintf without floating point (%f), %n (writeback) and %b (binary) conversions
+
+  One of the printf variants selected at link time by PRINTF_VARIANT in makefile.mk
+  - see nanoprintf.c for the implementation
+*/
+
+#define NANOPRINTF_USE_FIELD_WIDTH_FORMAT_SPECIFIERS 1
+#define NANOPRINTF_USE_PRECISION_FORMAT_SPECIFIERS 1
+#define NANOPRINTF_USE_FLOAT_FORMAT_SPECIFIERS 0
+#define NANOPRINTF_USE_LARGE_FORMAT_SPECIFIERS 1
+#define NANOPRINTF_USE_BINARY_FORMAT_SPECIFIERS 0
+#define NANOPRINTF_USE_WRITEBACK_FORMAT_SPECIFIERS 0
+
+#include "nanoprintf.c"
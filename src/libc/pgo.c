@@ -0,0 +1,96 @@
+/* Profile runtime for make pgo-instrument
+   ---------------------------------------
+
+Programs built with "make pgo-instrument" are compiled with -finstrument-functions, so the
+compiler adds a call to __cyg_profile_func_enter() at the start of every function. This counts
+the calls to each function and, when the program exits (through the atexit chain), writes the
+counts to PGO_FILE in the current directory.
+
+Copy the file(s) from one or more training runs to the project directory as *.prf, and
+"make pgo-use" will build the most called functions for speed (see agon-pgo.py).
+
+File format (little endian):
+    "AGPGO1"                    magic
+    uint24_t    entries
+    entries * { uint24_t function address, uint32_t count }
+
+This file is only linked when the instrumentation hooks are referenced.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <mos_api.h>
+
+#define PGO_FILE    "pgo.prf"
+#define PGO_SLOTS   512                 // must be a power of 2 - 3.5KB of BSS
+
+typedef struct {
+    uint24_t fn;
+    uint32_t count;
+} PGO_ENTRY;
+
+static PGO_ENTRY pgo_table[PGO_SLOTS];
+static uint24_t pgo_used = 0;
+static bool pgo_registered = false;
+
+#define PGO_NO_INSTRUMENT __attribute__((no_instrument_function))
+
+PGO_NO_INSTRUMENT static void pgo_write(void)
+{
+    static const char magic[] = "AGPGO1";
+    uint8_t fh = mos_fopen(PGO_FILE, FA_WRITE | FA_CREATE_ALWAYS);
+    uint24_t i;
+
+    if (!fh) return;
+
+    mos_fwrite(fh, (char *)magic, 6);
+    mos_fwrite(fh, (char *)&pgo_used, 3);
+    for (i = 0; i < PGO_SLOTS; i++)
+    {
+        if (pgo_table[i].fn) mos_fwrite(fh, (char *)&pgo_table[i], sizeof(PGO_ENTRY));
+    }
+    mos_fclose(fh);
+}
+
+PGO_NO_INSTRUMENT void __cyg_profile_func_enter(void *this_fn, void *call_site)
+{
+    uint24_t fn = (uint24_t)this_fn;
+    uint24_t i = (fn >> 2) & (PGO_SLOTS - 1);
+    uint24_t n;
+
+    (void)call_site;
+
+    if (!pgo_registered)
+    {
+        pgo_registered = true;
+        atexit(pgo_write);
+    }
+
+    // Open addressing with linear probing - if the table is full the call is not counted
+
+    for (n = 0; n < PGO_SLOTS; n++)
+    {
+        PGO_ENTRY *e = &pgo_table[i];
+
+        if (e->fn == fn)
+        {
+            e->count++;
+            return;
+        }
+        if (!e->fn)
+        {
+            e->fn = fn;
+            e->count = 1;
+            pgo_used++;
+            return;
+        }
+        i = (i + 1) & (PGO_SLOTS - 1);
+    }
+}
+
+PGO_NO_INSTRUMENT void __cyg_profile_func_exit(void *this_fn, void *call_site)
+{
+    (void)this_fn;
+    (void)call_site;
+}
@@ -0,0 +1,105 @@
+/* stdin line buffer
+   -----------------
+
+Input from stdin is read a line (console) or a block (redirected file) at a time into a buffer,
+which fgetc(), getchar(), fgets(), fread() and scanf() then read from.
+
+- Console input uses mos_editline, so MOS provides the line editing and echo. The line is
+  returned with a '\n' added. Pressing Escape ends the line and returns EOF.
+- Redirected input (e.g. "< file" handled by arg_processing) is read with mos_fread, and CR/LF
+  is translated to LF for text mode files.
+- fseek(), ftell() and freopen() on stdin account for (or discard) the buffered characters.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <mos_api.h>
+
+#define STDIN_BUF_SIZE 256
+
+static char stdin_buf[STDIN_BUF_SIZE];
+static size_t stdin_pos = 0;
+static size_t stdin_len = 0;
+
+static bool stdin_fill(void)
+{
+    uint8_t mos_fh = stdin->fhandle;
+
+    stdin_pos = 0;
+    if (mos_fh == FH_STDIN)
+    {
+        uint8_t key = mos_editline(stdin_buf, STDIN_BUF_SIZE - 1, 1);
+
+        outchar('\r');                  // MOS leaves the cursor at the end of the line
+        outchar('\n');
+        if (key == 27)                  // Escape
+        {
+            stdin_len = 0;
+            return false;
+        }
+        stdin_len = strlen(stdin_buf);
+        stdin_buf[stdin_len++] = '\n';
+    }
+    else
+    {
+        stdin_len = mos_fread(mos_fh, stdin_buf, STDIN_BUF_SIZE);
+    }
+    return stdin_len != 0;
+}
+
+int _stdin_getc(void)
+{
+    int c;
+
+    if (stdin_pos >= stdin_len && !stdin_fill()) return EOF;
+    c = (unsigned char)stdin_buf[stdin_pos++];
+
+    // Do CR/LF translation for redirected text files
+
+    if (c == '\r' && stdin->text_mode && stdin->fhandle != FH_STDIN)
+    {
+        if (stdin_pos >= stdin_len && !stdin_fill()) return c;
+        if (stdin_buf[stdin_pos] == '\n') c = stdin_buf[stdin_pos++];
+    }
+    return c;
+}
+
+// Block read for fread - copies directly from the buffer unless translation is needed
+
+size_t _stdin_read(char *ptr, size_t len)
+{
+    size_t nbytes = 0;
+    bool translate = stdin->text_mode && stdin->fhandle != FH_STDIN;
+
+    while (nbytes < len)
+    {
+        size_t chunk;
+
+        if (stdin_pos >= stdin_len && !stdin_fill()) break;
+        if (translate)
+        {
+            ptr[nbytes++] = _stdin_getc();
+            continue;
+        }
+        chunk = stdin_len - stdin_pos;
+        if (chunk > len - nbytes) chunk = len - nbytes;
+        memcpy(ptr + nbytes, stdin_buf + stdin_pos, chunk);
+        stdin_pos += chunk;
+        nbytes += chunk;
+    }
+    return nbytes;
+}
+
+// Number of characters read ahead into the buffer (for ftell / fseek)
+
+size_t _stdin_buffered(void)
+{
+    return stdin_len - stdin_pos;
+}
+
+void _stdin_discard(void)
+{
+    stdin_pos = stdin_len = 0;
+}
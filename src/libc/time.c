@@ -0,0 +1,154 @@
+/* time_t time(time_t *timer)
+   --------------------------
+
+Description
+The time() function returns the time as the number of seconds since the Epoch,
+1970-01-01 00:00:00 +0000 (UTC). If timer is non-NULL, the return value is also stored in
+the memory pointed to by timer.
+
+gettimeofday() and clock_gettime(CLOCK_REALTIME) return the same time with sub-second
+resolution. clock_gettime(CLOCK_MONOTONIC) returns the time since MOS started.
+
+Agon implementation
+Reading the RTC needs a request to the ESP32 via the VDP, so this is only done on the first call,
+every TIME_RESYNC_TICKS after that, or when time_resync() is called. In between the time is
+advanced from the sysvar clock (centiseconds, updated by MOS in the vertical blanking interrupt).
+- the RTC only has whole seconds, so a resync can step the sub-second part
+- the returned time never goes backwards - if a resync finds the cached time was ahead, the
+  returned time holds until the RTC catches up
+
+Return Value
+On success, the value of time in seconds since the Epoch is returned.
+*/
+
+#include <time.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <errno.h>
+#include <mos_api.h>
+
+#define TIME_RESYNC_TICKS   (10UL * 60UL * CLOCKS_PER_SEC)     // 10 minutes
+
+static bool time_synced = false;
+static uint32_t sync_ticks;             // sysvar time at the last resync
+static uint32_t last_ticks;             // sysvar time at the last update
+static time_t now_sec;                  // cached time ...
+static uint8_t now_cs;                  // ... and centiseconds
+static time_t out_sec;                  // last time returned (so it never goes backwards)
+static uint8_t out_cs;
+
+static char rtc_buffer[33];
+
+// Advance the cached time to the given sysvar time
+// - a small delta (the usual case when called often) needs no division
+
+static void time_update(uint32_t ticks)
+{
+    uint32_t delta = ticks - last_ticks;
+
+    last_ticks = ticks;
+    if (delta >= CLOCKS_PER_SEC)
+    {
+        now_sec += delta / CLOCKS_PER_SEC;
+        delta %= CLOCKS_PER_SEC;
+    }
+    now_cs += delta;
+    if (now_cs >= CLOCKS_PER_SEC)
+    {
+        now_cs -= CLOCKS_PER_SEC;
+        now_sec++;
+    }
+}
+
+void time_resync(void)
+{
+    volatile RTC_DATA *rtc = getsysvar_rtc();
+    struct tm tm;
+
+    mos_getrtc(rtc_buffer);             // Updates the sysvar RTC from the ESP32
+
+    tm.tm_sec  = rtc->second;
+    tm.tm_min  = rtc->minute;
+    tm.tm_hour = rtc->hour;
+    tm.tm_mday = rtc->day;
+    tm.tm_mon  = rtc->month;
+    tm.tm_year = rtc->year + 80;
+
+    last_ticks = sync_ticks = getsysvar_time();
+    now_sec = mktime(&tm);
+    now_cs = 0;
+    time_synced = true;
+}
+
+static void time_now(time_t *sec, uint8_t *cs)
+{
+    uint32_t ticks = getsysvar_time();
+
+    if (!time_synced || ticks - sync_ticks >= TIME_RESYNC_TICKS) time_resync();
+    else time_update(ticks);
+
+    if (now_sec > out_sec || (now_sec == out_sec && now_cs > out_cs))
+    {
+        out_sec = now_sec;
+        out_cs = now_cs;
+    }
+    *sec = out_sec;
+    *cs = out_cs;
+}
+
+time_t time(time_t *timer)
+{
+    time_t sec;
+    uint8_t cs;
+
+    time_now(&sec, &cs);
+    if (timer) *timer = sec;
+
+    return sec;
+}
+
+int gettimeofday(struct timeval *tv, void *tz)
+{
+    uint8_t cs;
+
+    (void)tz;
+    if (tv == NULL) return 0;
+
+    time_now(&tv->tv_sec, &cs);
+    tv->tv_usec = cs * 10000L;
+
+    return 0;
+}
+
+int clock_gettime(clockid_t clk_id, struct timespec *tp)
+{
+    uint8_t cs;
+
+    if (tp == NULL)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (clk_id == CLOCK_REALTIME)
+    {
+        time_now(&tp->tv_sec, &cs);
+    }
+    else if (clk_id == CLOCK_MONOTONIC)
+    {
+        uint32_t ticks = getsysvar_time();
+
+        tp->tv_sec = ticks / CLOCKS_PER_SEC;
+        cs = ticks % CLOCKS_PER_SEC;
+    }
+    else
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    tp->tv_nsec = cs * 10000000L;
+
+    return 0;
+}
@@ -21,6 +21,8 @@ APPEND_FILES = $(foreach file,$(addprefix ../lib/$2/,$(notdir $3)),$(call APPEND
 
 CRT_FILES := $(filter-out crt/crt0.src,$(wildcard crt/*.src) $(patsubst crt/%,crt/build/%.src,$(wildcard crt/*.c crt/*.cpp)))
 LIBC_FILES := $(wildcard libc/*.src) $(patsubst libc/%,libc/build/%.src,$(wildcard libc/*.c libc/*.cpp))
+PRINTF_FILES := $(filter libc/build/nanoprintf%,$(LIBC_FILES))
+LIBC_FILES := $(filter-out $(PRINTF_FILES),$(LIBC_FILES))
 LIBCXX_FILES := $(wildcard libcxx/*.src) $(patsubst libcxx/%,libcxx/build/%.src,$(wildcard libcxx/*.c libcxx/*.cpp))
 AGON_FILES := $(wildcard agon/*.src) $(patsubst agon/%,agon/build/%.src,$(wildcard agon/*.c agon/*.cpp))
 
@@ -59,6 +61,16 @@ linker_script: $(STATIC_FILES) $(LINKED_FILES) $(SHARED_FILES)
 	$(Q)$(call APPEND_FILES,	source ,agon,$(sort $(AGON_FILES)))
 	$(Q)$(call APPEND,if HAS_LIBC)
 	$(Q)$(call APPEND_FILES,	source ,libc,$(sort $(LIBC_FILES)))
+	$(Q)$(call APPEND,	if ~ defined PRINTF_VARIANT)
+	$(Q)$(call APPEND,		PRINTF_VARIANT := 0)
+	$(Q)$(call APPEND,	end if)
+	$(Q)$(call APPEND,	if PRINTF_VARIANT = 2)
+	$(Q)$(call APPEND_FILES,		source ,libc,libc/build/nanoprintf_int.c.src)
+	$(Q)$(call APPEND,	else if PRINTF_VARIANT = 1)
+	$(Q)$(call APPEND_FILES,		source ,libc,libc/build/nanoprintf_nowb.c.src)
+	$(Q)$(call APPEND,	else)
+	$(Q)$(call APPEND_FILES,		source ,libc,libc/build/nanoprintf.c.src)
+	$(Q)$(call APPEND,	end if)
 	$(Q)$(call APPEND,end if)
 	$(Q)$(call APPEND,if HAS_LIBCXX)
 	$(Q)$(call APPEND_FILES,	source ,libcxx,$(sort $(LIBCXX_FILES)))
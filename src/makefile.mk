@@ -45,6 +45,13 @@ HAS_LIBC ?= YES
 HAS_LIBCXX ?= YES
 HAS_AGON ?= YES
 HAS_ARG_PROCESSING ?= NO
+PRINTF_VARIANT ?= AUTO
+# PRINTF_VARIANT ?= FULL | NOWB | INT
+PGO ?= NO
+# PGO ?= INSTRUMENT | USE (set by the pgo-instrument and pgo-use targets)
+PGO_HOT ?= 90
+PGO_HOT_CFLAGS ?= -O2
+MOS_ACCOUNTING ?= NO
 ALLOCATOR ?= SIMPLE
 # ALLOCATOR ?= STANDARD
 PREFER_OS_CRT ?= NO
@@ -76,6 +83,8 @@ LDHAS_LIBCXX := 0
 LDHAS_AGON := 1
 LDHAS_ARG_PROCESSING ?= 0
 LDHAS_EXIT_HANDLER ?= 1
+LDMOS_ACCOUNTING := 0
+LDPRINTF_VARIANT := 0
 
 # verbosity
 V ?= 0
@@ -100,6 +109,7 @@ RM = ( del /q /f $1 2>nul || call )
 RMDIR = ( rmdir /s /q $1 2>nul || call )
 NATIVEMKDR = ( mkdir $1 2>nul || call )
 QUOTE_ARG = "$(subst ",',$1)"#'
+PGO_TOOL ?= python $(call NATIVEPATH,$(BIN)/agon-pgo.py)
 else
 NATIVEPATH = $(subst \,/,$1)
 FASMG = $(call NATIVEPATH,$(BIN)/fasmg)
@@ -110,6 +120,7 @@ RM = rm -f $1
 RMDIR = rm -rf $1
 NATIVEMKDR = mkdir -p $1
 QUOTE_ARG = '$(subst ','\'',$1)'#'
+PGO_TOOL ?= python3 $(call NATIVEPATH,$(BIN)/agon-pgo.py)
 endif
 
 MKDIR = $(call NATIVEMKDR,$(call QUOTE_ARG,$(call NATIVEPATH,$1)))
@@ -152,6 +163,32 @@ ASMSOURCES = $(sort $(call rwildcard,$(SRCDIR),*.asm) $(EXTRA_ASM_SOURCES))
 ifneq ($(filter debug,$(MAKECMDGOALS)),)
 LTO := NO
 endif
+
+# profile guided build (see pgo-instrument and pgo-use below)
+# - INSTRUMENT: every function calls __cyg_profile_func_enter (libc pgo.c), which counts the
+#   calls and writes them to pgo.prf when the program exits
+# - USE: the source files holding the functions that make up PGO_HOT % of the calls in the
+#   *.prf files are compiled with PGO_HOT_CFLAGS added, the rest with CFLAGS only. The list is
+#   kept in $(OBJDIR)/pgo-hot.txt, which is only rewritten when it changes, and every file
+#   depends on it so that new profiles rebuild them with the right flags
+# LTO is turned off for both, as the flags are per file and the map must name each function
+ifeq ($(PGO),INSTRUMENT)
+LTO := NO
+OUTPUT_MAP := YES
+EZPGOFLAGS := -finstrument-functions
+else ifeq ($(PGO),USE)
+LTO := NO
+PGO_STAMP := $(call NATIVEPATH,$(OBJDIR)/pgo-hot.txt)
+PGO_HOT_FILES := $(shell $(PGO_TOOL) --map $(PGO_MAP) --objdir $(PGO_OBJDIR) --hot $(PGO_HOT) --stamp $(PGO_STAMP) $(wildcard *.prf))
+endif
+PGO_FILE_FLAGS = $(if $(filter $1,$(PGO_HOT_FILES)),$(PGO_HOT_CFLAGS))
+
+# MOS call accounting (see mos-acct below): the accounted mos_api.src routines count their calls
+# and the time spent in MOS, and the getsysvar_* inlines count their reads
+ifeq ($(MOS_ACCOUNTING),YES)
+LDMOS_ACCOUNTING := 1
+EZACCTFLAGS := -DMOS_ACCOUNTING
+endif
 ifeq ($(LTO),YES)
 LINK_CSOURCES = $(call UPDIR_ADD,$(CSOURCES:%.$(C_EXTENSION)=$(OBJDIR)/%.$(C_EXTENSION).bc))
 LINK_CPPSOURCES = $(call UPDIR_ADD,$(CPPSOURCES:%.$(CPP_EXTENSION)=$(OBJDIR)/%.$(CPP_EXTENSION).bc))
@@ -208,9 +245,41 @@ ifeq ($(HAS_AGON),YES)
 LDHAS_AGON := 1
 endif
 
+# select the printf variant linked
+# - FULL: all conversions, NOWB: no %n or %b, INT: also no %f
+# - AUTO: looks for format specifiers in the source files and the headers under $(SRCDIR), and
+#   picks the smallest variant that handles them. Format strings built at run time are not seen,
+#   so a printf family call whose format isn't a string literal (e.g. printf( fmt, ... ) or a
+#   vprintf wrapper) selects FULL - set the variant if that's not needed
+PRINTF_FLAGS_RE := %[-+ \#0-9.*]*[hlLjzt]*
+PRINTF_RUNTIME_RE := (^|[^a-z_])printf *\( *[A-Za-z_]|[fs]printf *\([^,]*, *[A-Za-z_]|snprintf *\([^,]*,[^,]*, *[A-Za-z_]
+ifeq ($(PRINTF_VARIANT),AUTO)
+ifeq ($(OS),Windows_NT)
+PRINTF_VARIANT := FULL
+else
+PRINTF_SCAN = $(CSOURCES) $(CPPSOURCES) $(call rwildcard,$(SRCDIR),*.h) $(call rwildcard,$(SRCDIR),*.hpp) $(EXTRA_HEADERS)
+PRINTF_FMT_USED = $(shell grep -l -E -e '$1' $(PRINTF_SCAN) /dev/null 2>/dev/null)
+ifneq ($(call PRINTF_FMT_USED,$(PRINTF_RUNTIME_RE)),)
+PRINTF_VARIANT := FULL
+else ifneq ($(call PRINTF_FMT_USED,$(PRINTF_FLAGS_RE)[nbB]),)
+PRINTF_VARIANT := FULL
+else ifneq ($(call PRINTF_FMT_USED,$(PRINTF_FLAGS_RE)[fF]),)
+PRINTF_VARIANT := NOWB
+else
+PRINTF_VARIANT := INT
+endif
+endif
+endif
+ifeq ($(PRINTF_VARIANT),NOWB)
+LDPRINTF_VARIANT := 1
+endif
+ifeq ($(PRINTF_VARIANT),INT)
+LDPRINTF_VARIANT := 2
+endif
+
 # define the c/c++ flags used by clang
 EZLLVMFLAGS = -mllvm -profile-guided-section-prefix=false
-EZCOMMONFLAGS = -nostdinc -isystem $(call NATIVEPATH,$(CEDEV_TOOLCHAIN)/include) -I$(SRCDIR) -fno-threadsafe-statics -Xclang -fforce-mangle-main-argc-argv $(EZLLVMFLAGS) -D$(DEBUGMODE) $(DEFCUSTOMFILE) $(CCDEBUG)
+EZCOMMONFLAGS = -nostdinc -isystem $(call NATIVEPATH,$(CEDEV_TOOLCHAIN)/include) -I$(SRCDIR) -fno-threadsafe-statics -Xclang -fforce-mangle-main-argc-argv $(EZLLVMFLAGS) -D$(DEBUGMODE) $(DEFCUSTOMFILE) $(CCDEBUG) $(EZPGOFLAGS) $(EZACCTFLAGS)
 EZCFLAGS = $(EZCOMMONFLAGS) $(CFLAGS)
 EZCXXFLAGS = $(EZCOMMONFLAGS) -isystem $(call NATIVEPATH,$(CEDEV_TOOLCHAIN)/include/c++) -fno-exceptions -fno-use-cxa-atexit $(CXXFLAGS)
 EZAGONFLAGS = $(EZCOMMONFLAGS) -isystem $(call NATIVEPATH,$(CEDEV_TOOLCHAIN)/include/agon) -fno-exceptions -fno-use-cxa-atexit $(AGONFLAGS)
@@ -229,6 +298,8 @@ FASMGFLAGS = \
 	-i $(call QUOTE_ARG,PREFER_OS_LIBC := $(LDPREFER_OS_LIBC)) \
 	-i $(call QUOTE_ARG,HAS_EXIT_HANDLER := $(LDHAS_EXIT_HANDLER)) \
 	-i $(call QUOTE_ARG,HAS_ARG_PROCESSING := $(LDHAS_ARG_PROCESSING)) \
+	-i $(call QUOTE_ARG,PRINTF_VARIANT := $(LDPRINTF_VARIANT)) \
+	-i $(call QUOTE_ARG,MOS_ACCOUNTING := $(LDMOS_ACCOUNTING)) \
 	-i $(call QUOTE_ARG,include $(call FASMG_FILES,$(LINKER_SCRIPT))) \
 	-i $(call QUOTE_ARG,range .bss $$$(BSSHEAP_LOW) : $$$(BSSHEAP_HIGH)) \
 	-i $(call QUOTE_ARG,provide __stack = $$$(STACK_HIGH)) \
@@ -242,7 +313,7 @@ FASMGFLAGS = \
 #	-i $(call QUOTE_ARG,provide __stack = $$$(STACK_HIGH)) \
 
 
-.PHONY: all clean version gfx debug
+.PHONY: all clean version gfx debug pgo-instrument pgo-use mos-acct
 
 # this rule is trigged to build everything
 all: $(BINDIR)/$(TARGETBIN)
@@ -258,6 +329,25 @@ $(BINDIR)/$(TARGETBIN): $(LDFILES) $(MAKEFILE_LIST) $(DEPS)
 	$(Q)echo [linking] $(call NATIVEPATH,$@)
 	$(Q)$(FASMG) $(FASMGFLAGS) $(call NATIVEPATH,$@)
 
+# profile guided build
+# 1. make pgo-instrument, then run bin/pgo/$(TARGETBIN) on the Agon (or emulator) with typical use
+# 2. copy the pgo.prf it writes into this directory as *.prf (several runs are merged)
+# 3. make pgo-use builds $(BINDIR)/$(TARGETBIN) with the hot files optimised for speed
+PGO_BUILD = $(MAKE) --no-print-directory -f $(call QUOTE_ARG,$(firstword $(MAKEFILE_LIST)))
+
+pgo-instrument:
+	$(Q)$(PGO_BUILD) PGO=INSTRUMENT OBJDIR=$(call NATIVEPATH,$(OBJDIR)/pgo-instrument) BINDIR=$(call NATIVEPATH,$(BINDIR)/pgo)
+	$(Q)echo Run $(call NATIVEPATH,$(BINDIR)/pgo/$(TARGETBIN)) and copy the pgo.prf it writes here as *.prf, then make pgo-use.
+
+pgo-use:
+	$(Q)$(PGO_BUILD) PGO=USE OBJDIR=$(call NATIVEPATH,$(OBJDIR)/pgo-use) \
+		PGO_OBJDIR=$(call NATIVEPATH,$(OBJDIR)/pgo-instrument) PGO_MAP=$(call NATIVEPATH,$(BINDIR)/pgo/$(TARGETMAP))
+
+# MOS call accounting build - run bin/mos-acct/$(TARGETBIN), the totals are written to mosacct.txt
+# when it exits (see mos_acct.h)
+mos-acct:
+	$(Q)$(PGO_BUILD) MOS_ACCOUNTING=YES OBJDIR=$(call NATIVEPATH,$(OBJDIR)/mos-acct) BINDIR=$(call NATIVEPATH,$(BINDIR)/mos-acct)
+
 clean:
 	$(Q)$(EXTRA_CLEAN)
 	$(Q)$(call RMDIR,$(OBJDIR) $(BINDIR))
@@ -275,15 +365,20 @@ version:
 .SECONDEXPANSION:
 
 # no lto
-$(OBJDIR)/%.$(C_EXTENSION).src: $$(call UPDIR_RM,$$*).$(C_EXTENSION) $(EXTRA_HEADERS) $(MAKEFILE_LIST) $(DEPS)
+$(OBJDIR)/%.$(C_EXTENSION).src: $$(call UPDIR_RM,$$*).$(C_EXTENSION) $(EXTRA_HEADERS) $(MAKEFILE_LIST) $(DEPS) $(PGO_STAMP)
 	$(Q)$(call MKDIR,$(@D))
 	$(Q)echo [compiling] $(call NATIVEPATH,$<)
-	$(Q)$(CC) -S -MD $(EZCFLAGS) $(call QUOTE_ARG,$<) -o $(call QUOTE_ARG,$@)
+	$(Q)$(CC) -S -MD $(EZCFLAGS) $(call PGO_FILE_FLAGS,$<) $(call QUOTE_ARG,$<) -o $(call QUOTE_ARG,$@)
 
-$(OBJDIR)/%.$(CPP_EXTENSION).src: $$(call UPDIR_RM,$$*).$(CPP_EXTENSION) $(EXTRA_HEADERS) $(MAKEFILE_LIST) $(DEPS)
+$(OBJDIR)/%.$(CPP_EXTENSION).src: $$(call UPDIR_RM,$$*).$(CPP_EXTENSION) $(EXTRA_HEADERS) $(MAKEFILE_LIST) $(DEPS) $(PGO_STAMP)
 	$(Q)$(call MKDIR,$(@D))
 	$(Q)echo [compiling] $(call NATIVEPATH,$<)
-	$(Q)$(CC) -S -MD $(EZCXXFLAGS) $(call QUOTE_ARG,$<) -o $(call QUOTE_ARG,$@)
+	$(Q)$(CC) -S -MD $(EZCXXFLAGS) $(call PGO_FILE_FLAGS,$<) $(call QUOTE_ARG,$<) -o $(call QUOTE_ARG,$@)
+
+# written by $(PGO_TOOL) when the makefile is read - this is in case it couldn't be
+ifneq ($(PGO_STAMP),)
+$(PGO_STAMP): ;
+endif
 
 # lto
 $(LDLTO): $(LDBCLTO)
@@ -303,6 +398,6 @@ $(OBJDIR)/%.$(CPP_EXTENSION).bc: $$(call UPDIR_RM,$$*).$(CPP_EXTENSION) $(EXTRA_
 	$(Q)echo [compiling] $(call NATIVEPATH,$<)
 	$(Q)$(CC) -MD -c -emit-llvm $(EZCXXFLAGS) $(call QUOTE_ARG,$<) -o $(call QUOTE_ARG,$@)
 
-ifeq ($(filter clean gfx test version,$(MAKECMDGOALS)),)
+ifeq ($(filter clean gfx test version pgo-instrument pgo-use mos-acct,$(MAKECMDGOALS)),)
 -include $(DEPFILES)
 endif
@@ -0,0 +1,89 @@
+/*
+ * Title:			atlas - tests sprite sheet atlas loading
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+#include <agon/vdp_atlas.h>
+
+#define SIZE		16
+#define FRAMES		8
+#define FIRST_ID	0xFA00			// bitmap 0
+#define TEMP_ID		0x2000
+
+static uint32_t frame[SIZE * SIZE];
+
+// Write an atlas of FRAMES frames with a bar moving round the edge of a square
+
+static int write_test_atlas( const char *fname )
+{
+	static const uint8_t header[12] = { 'A', 'G', 'A', 'T', 1, VDP_ATLAS_RGBA8888, SIZE, 0, SIZE, 0, FRAMES, 0 };
+	FILE *fp = fopen( fname, "wb" );
+	int n, x, y;
+
+	if ( !fp ) return -1;
+	fwrite( header, 1, sizeof( header ), fp );
+	for ( n = 0; n < FRAMES; n++ ) {
+		for ( y = 0; y < SIZE; y++ ) {
+			for ( x = 0; x < SIZE; x++ ) {
+				bool edge = x == 0 || y == 0 || x == SIZE - 1 || y == SIZE - 1;
+				bool bar = ( x + y ) / 4 == n || ( x + SIZE - y ) / 4 == n;
+
+				frame[y * SIZE + x] = edge ? 0xFFFFFFFFUL : bar ? 0xFF00FF00UL : 0;
+			}
+		}
+		fwrite( frame, sizeof( uint32_t ), SIZE * SIZE, fp );
+	}
+	fclose( fp );
+	return 0;
+}
+
+int main( int argc, char *argv[] )
+{
+	const char *fname = argc > 1 ? argv[1] : "test.atl";
+	VDP_ATLAS info;
+	uint32_t start;
+	int frames, i;
+
+	if ( argc < 2 && write_test_atlas( fname ) ) {
+		printf( "Can't write %s\r\n", fname );
+		return 1;
+	}
+
+	vdp_mode( 8 );
+	vdp_clear_screen();
+
+	start = getsysvar_time();
+	frames = vdp_atlas_load( fname, FIRST_ID, TEMP_ID, &info );
+	if ( frames < 0 ) {
+		printf( "Can't load %s\r\n", fname );
+		return 1;
+	}
+	printf( "%d frames of %dx%d loaded in %lu cs\r\n", frames, info.width, info.height, getsysvar_time() - start );
+
+	for ( i = 0; i < frames; i++ ) {
+		vdp_adv_select_bitmap( FIRST_ID + i );
+		vdp_draw_bitmap( 20 + i * ( info.width + 4 ), 40 );
+	}
+
+	vdp_adv_create_sprite( 0, FIRST_ID, frames );
+	vdp_select_sprite( 0 );
+	vdp_move_sprite_to( 150, 100 );
+	vdp_show_sprite();
+	vdp_activate_sprites( 1 );
+
+	for ( i = 0; i < frames * 8; i++ ) {
+		vdp_select_sprite( 0 );
+		vdp_next_sprite_frame();
+		vdp_refresh_sprites();
+		start = getsysvar_time();
+		while ( getsysvar_time() - start < 10 );
+	}
+	return 0;
+}
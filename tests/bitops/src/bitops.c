@@ -0,0 +1,82 @@
+/*
+ * Title:			bitops - tests and benchmarks bitops.h against the compiler builtins
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <bitops.h>
+
+#define VALUES	256
+#define LOOPS	20
+
+static uint32_t values[VALUES];
+static volatile uint24_t sink;
+
+typedef uint24_t (*OP)( uint32_t x );
+
+static uint24_t op_clz( uint32_t x )		{ return bit_clz32( x ); }
+static uint24_t op_ctz( uint32_t x )		{ return bit_ctz32( x ); }
+static uint24_t op_popcount( uint32_t x )	{ return bit_popcount32( x ); }
+static uint24_t op_bswap( uint32_t x )		{ return bit_bswap32( x ) >> 8; }
+
+static uint24_t builtin_clz( uint32_t x )		{ return __builtin_clzl( x ); }
+static uint24_t builtin_ctz( uint32_t x )		{ return __builtin_ctzl( x ); }
+static uint24_t builtin_popcount( uint32_t x )	{ return __builtin_popcountl( x ); }
+static uint24_t builtin_bswap( uint32_t x )		{ return __builtin_bswap32( x ) >> 8; }
+
+static clock_t time_op( OP op )
+{
+	clock_t start = clock();
+	int loop, i;
+
+	for ( loop = 0; loop < LOOPS; loop++ ) {
+		for ( i = 0; i < VALUES; i++ ) sink = op( values[i] );
+	}
+	return clock() - start;
+}
+
+static int check( const char *name, OP op, OP ref )
+{
+	int i, errors = 0;
+
+	for ( i = 0; i < VALUES; i++ ) {
+		if ( op( values[i] ) != ref( values[i] ) ) {
+			if ( errors++ < 4 ) printf( "%s(%08lX) = %u, builtin %u\r\n", name, values[i], op( values[i] ), ref( values[i] ) );
+		}
+	}
+	printf( "%-9s bitops.h %5lu  builtin %5lu  %s\r\n", name,
+			(unsigned long)time_op( op ), (unsigned long)time_op( ref ), errors ? "FAIL" : "ok" );
+	return errors;
+}
+
+int main( void )
+{
+	uint32_t seed = 12345;
+	int i, errors = 0;
+
+	for ( i = 0; i < VALUES; i++ ) {
+		seed = seed * 1103515245UL + 12345;
+		values[i] = ( seed | 1UL << 31 ) >> ( i & 31 ) << ( ( i >> 5 ) & 7 );
+		if ( !values[i] ) values[i] = 1;
+	}
+
+	errors += check( "clz", op_clz, builtin_clz );
+	errors += check( "ctz", op_ctz, builtin_ctz );
+	errors += check( "popcount", op_popcount, builtin_popcount );
+	errors += check( "bswap", op_bswap, builtin_bswap );
+
+	// Zero and the 8 / 24-bit forms
+
+	if ( bit_clz32( 0 ) != 32 || bit_ctz32( 0 ) != 32 || bit_popcount32( 0 ) != 0 ) errors++;
+	if ( bit_clz24( 0 ) != 24 || bit_ctz24( 0 ) != 24 || bit_clz8( 0 ) != 8 || bit_ctz8( 0 ) != 8 ) errors++;
+	if ( bit_clz8( 0x10 ) != 3 || bit_ctz8( 0x10 ) != 4 || bit_popcount8( 0xA5 ) != 4 ) errors++;
+	if ( bit_ffs24( 0x800000 ) != 24 || bit_fls24( 0x800000 ) != 24 || bit_ffs8( 0 ) != 0 ) errors++;
+	if ( bit_bswap24( 0x123456 ) != 0x563412 || bit_bswap16( 0x1234 ) != 0x3412 ) errors++;
+
+	printf( errors ? "%d errors\r\n" : "All correct\r\n", errors );
+	return errors != 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * Title:			capture - tests VDU stream capture
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+#include <agon/vdp_capture.h>
+
+#define FRAMES		50
+
+static VDP_CAPTURE_FRAME frames[FRAMES];
+static uint8_t raw[8192];
+static uint32_t ball[8 * 8];
+
+int main( void )
+{
+	int x = 10, y = 10, dx = 3, dy = 2;
+
+	for ( int i = 0; i < 8 * 8; i++ ) ball[i] = 0xFF00C0FFUL;
+
+	vdp_mode( 8 );
+	vdp_logical_scr_dims( false );
+	vdp_get_scr_dims( true );
+	vdp_cursor_enable( false );
+
+	vdp_capture_start( frames, FRAMES, raw, sizeof( raw ) );
+
+	vdp_select_bitmap( 0 );
+	vdp_load_bitmap( 8, 8, ball );
+	vdp_create_sprite( 0, 0, 1 );
+	vdp_select_sprite( 0 );
+	vdp_show_sprite();
+	vdp_activate_sprites( 1 );
+	vdp_capture_frame();
+
+	for ( int f = 1; f < FRAMES; f++ ) {
+		if ( x + dx < 0 || x + dx > 310 ) dx = -dx;
+		if ( y + dy < 20 || y + dy > 230 ) dy = -dy;
+		x += dx;
+		y += dy;
+		vdp_select_sprite( 0 );
+		vdp_move_sprite_to( x, y );
+		vdp_refresh_sprites();
+
+		vdp_gcol( 0, f & 15 );
+		vdp_move_to( 0, 20 + f * 4 );
+		vdp_line_to( 319, 20 + f * 4 );
+
+		vdp_cursor_tab( 0, 0 );
+		printf( "Frame %2d", f );
+		vdp_capture_frame();
+	}
+
+	vdp_capture_stop();
+	vdp_mode( 0 );
+	vdp_capture_print();
+	if ( vdp_capture_dump( "capture.vdc" ) ) printf( "Can't write capture.vdc\r\n" );
+	return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Title:			clip - tests client side clipping of plot commands
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+
+#define STARS		200
+#define WORLD_W		( 8 * 320 )
+#define FRAMES		20
+
+static int star_x[STARS], star_y[STARS];
+
+static uint32_t run( bool clip )
+{
+	uint32_t start = getsysvar_time();
+
+	vdp_clip_enable( clip );
+	for ( int f = 0; f < FRAMES; f++ ) {
+		int scroll = f * 16;
+
+		vdp_clear_graphics();
+		for ( int i = 0; i < STARS; i++ ) {
+			int x = star_x[i] - scroll;
+
+			vdp_point( x, star_y[i] );
+			vdp_move_to( x - 4, star_y[i] + 8 );
+			vdp_line_to( x + 4, star_y[i] + 8 );
+		}
+	}
+	vdp_clip_sync();
+	return getsysvar_time() - start;
+}
+
+int main( void )
+{
+	uint32_t on, off;
+
+	srand( 1 );
+	for ( int i = 0; i < STARS; i++ ) {
+		star_x[i] = rand() % WORLD_W;
+		star_y[i] = 20 + rand() % 180;
+	}
+
+	vdp_mode( 8 );								// 320 x 240
+	vdp_logical_scr_dims( false );				// pixel coordinates
+	vdp_get_scr_dims( true );
+	vdp_set_graphics_viewport( 40, 220, 279, 20 );
+	vdp_gcol( 0, 15 );
+
+	on = run( true );
+	off = run( false );
+
+	vdp_reset_viewports();
+	vdp_cursor_home();
+	printf( "%d frames of %d stars in a %d wide world\r\n", FRAMES, STARS, WORLD_W );
+	printf( "Clipping on:  %lu cs\r\nClipping off: %lu cs\r\n", on, off );
+	return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Title:			contain - tests fixed capacity containers
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <mos_api.h>
+#include <agon/static_vector.hpp>
+#include <agon/ring_buffer.hpp>
+#include <agon/small_string.hpp>
+#include <agon/flat_map.hpp>
+
+using namespace agon;
+
+struct Entity {
+	int x, y;
+	uint8_t id;
+};
+
+int main( void )
+{
+	static_vector<Entity, 8> entities;
+	ring_buffer<uint8_t, 16> keys;
+	small_string<20> name( "player" );
+	flat_map<uint8_t, int, 16> scores;
+	uint8_t id;
+
+	// static_vector
+
+	for ( id = 0; entities.push_back( Entity{ id * 10, id * 5, id } ); id++ );
+	printf( "static_vector: %u of %u after filling\r\n", entities.size(), entities.capacity() );
+	entities.erase_unordered( 2 );
+	entities.erase( 0 );
+	for ( const Entity &e : entities ) printf( " %u:(%d,%d)", e.id, e.x, e.y );
+	printf( "\r\n" );
+
+	// small_string
+
+	name += '_';
+	name += 42;
+	printf( "small_string: \"%s\" (%u)\r\n", name.c_str(), name.size() );
+	if ( !name.append( " with a long suffix" ) ) printf( "truncated to \"%s\"\r\n", name.c_str() );
+
+	// flat_map
+
+	// 20 keys from 58 down to 1 - the last 4 don't fit
+
+	int rejected = 0;
+
+	for ( int key = 58; key > 0; key -= 3 ) {
+		if ( !scores.insert( key, key * 100 ) ) rejected++;
+	}
+	printf( "flat_map: %u of %u after filling, %d rejected\r\n", scores.size(), scores.capacity(), rejected );
+	scores.erase( 31 );
+	printf( "flat_map: %u entries\r\n", scores.size() );
+	for ( auto &s : scores ) printf( " %u=%d", s.key, s.value );
+	printf( "\r\nscore for 40: %d, 31 present: %d\r\n", *scores.find( 40 ), scores.contains( 31 ) );
+
+	// ring_buffer
+
+	printf( "ring_buffer: type keys, Escape to end\r\n" );
+	for ( ;; ) {
+		uint8_t c = getsysvar_keyascii();
+
+		if ( c && getsysvar_vkeydown() ) {
+			if ( !keys.push( c ) ) printf( "full\r\n" );
+			while ( getsysvar_vkeydown() );
+		}
+		while ( keys.pop( c ) ) {
+			if ( c == 27 ) return 0;
+			putchar( c );
+		}
+	}
+}
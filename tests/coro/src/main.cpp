@@ -0,0 +1,65 @@
+/*
+ * Title:			coro - tests C++20 coroutine scripts
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+#include <agon/coro.hpp>
+
+static agon::Script entity( const char *name, int x, int dx, uint24_t ticks )
+{
+	for ( int i = 0; i < 5; i++ ) {
+		printf( "%s at %d\r\n", name, x );
+		x += dx;
+		co_await agon::sleep( ticks );
+	}
+	printf( "%s done\r\n", name );
+}
+
+static agon::Script screen_query()
+{
+	auto reply = agon::vdp_reply( vdp_pflag_mode );
+
+	vdp_get_scr_dims( false );
+	co_await reply;
+	printf( "Screen %d x %d\r\n", getsysvar_scrwidth(), getsysvar_scrheight() );
+}
+
+static agon::Script loader( const char *filename )
+{
+	static char buf[4096];
+	uint8_t fh = mos_fopen( filename, FA_READ );
+
+	if ( !fh ) {
+		printf( "Can't open %s\r\n", filename );
+		co_return;
+	}
+	size_t got = co_await agon::read_chunks( fh, buf, sizeof( buf ) );
+	mos_fclose( fh );
+	printf( "Loaded %u bytes of %s\r\n", got, filename );
+}
+
+int main( void )
+{
+	uint24_t passes = 0;
+
+	if ( !agon::spawn( entity( "alien", 0, 8, 20 ) ) ||
+		 !agon::spawn( entity( "ship", 100, -4, 35 ) ) ||
+		 !agon::spawn( screen_query() ) ||
+		 !agon::spawn( loader( "coro.bin" ) ) ) {
+		printf( "No frame for a script\r\n" );
+		return 1;
+	}
+
+	while ( agon::run_once() ) {
+		passes++;
+	}
+
+	printf( "%u passes of run_once()\r\n", passes );
+	return 0;
+}
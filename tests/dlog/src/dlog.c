@@ -0,0 +1,64 @@
+/*
+ * Title:			dlog - tests deferred format binary logging
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <mos_api.h>
+#include <agon/dlog.h>
+
+#define FRAMES		200
+#define CALLS		1000
+
+static uint8_t ring[8192];
+static char line[64];
+
+int main( void )
+{
+	int x = 0, v = 3;
+	float energy = 100.0f;
+	uint32_t start, dlog_time, sprintf_time;
+	int i;
+
+	if ( !dlog_init( ring, sizeof( ring ) ) || !dlog_open( "dlog.dlg" ) ) {
+		printf( "Can't open dlog.dlg\r\n" );
+		return 1;
+	}
+	DLOG( "dlog demo: %d frames", FRAMES );
+
+	for ( int frame = 0; frame < FRAMES; frame++ ) {
+		x += v;
+		if ( x < 0 || x > 320 ) {
+			v = -v;
+			DLOG( "frame %d: bounce at x=%d, v now %d", frame, x, v );
+		}
+		energy *= 0.99f;
+		DLOG( "frame %d: x=%d energy=%.2f", frame, x, energy );
+		dlog_poll( 128 );
+	}
+
+	// The cost of logging the same message each way
+
+	start = getsysvar_time();
+	for ( i = 0; i < CALLS; i++ ) {
+		DLOG( "call %d of %d x=%d", i, CALLS, x );
+		if ( dlog_pending() > sizeof( ring ) / 2 ) dlog_flush();
+	}
+	dlog_time = getsysvar_time() - start;
+	dlog_flush();
+
+	start = getsysvar_time();
+	for ( i = 0; i < CALLS; i++ ) sprintf( line, "call %d of %d x=%d", i, CALLS, x );
+	sprintf_time = getsysvar_time() - start;
+
+	DLOG( "done, %u records dropped", dlog_dropped() );
+	dlog_close();
+
+	printf( "%d DLOG() calls:    %lu cs (including flushes)\r\n", CALLS, dlog_time );
+	printf( "%d sprintf() calls: %lu cs\r\n", CALLS, sprintf_time );
+	printf( "Decode dlog.dlg with dlog.py\r\n" );
+	return 0;
+}
@@ -0,0 +1,160 @@
+/*
+ * Title:			fontlib - tests glyph upload, kerning and cached strings in fontlibc
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <limits.h>
+#include <mos_api.h>
+#include <fontlibc.h>
+#include <agon/vdp_vdu.h>
+#include <agon/vdp_capture.h>
+
+#define FIRST		0x20
+#define GLYPHS		( 0x7F - FIRST )
+#define HEIGHT		8
+#define WIDTH		6
+
+// A font built in RAM, laid out as a font pack would hold it - the widths and bitmaps offsets
+// are from the start of the font
+
+typedef struct {
+	fontlib_font_t font;
+	uint8_t widths[GLYPHS];
+	uint16_t bitmaps[GLYPHS];
+	uint8_t data[GLYPHS][HEIGHT];
+} TEST_FONT;
+
+static TEST_FONT test_font;
+
+static const fontlib_kern_pair_t kern[] = {
+	{ 'A', 'V', -2 },
+	{ 'T', 'A', -1 },
+	{ 'V', 'A', -2 },
+};
+
+static int failed;
+
+static void check( const char *what, bool ok )
+{
+	printf( "%s: %s\r\n", what, ok ? "ok" : "FAIL" );
+	if ( !ok ) failed++;
+}
+
+// Each glyph is a box with its code point in the rows inside, so they all differ
+
+static void make_font( void )
+{
+	fontlib_font_t *f = &test_font.font;
+
+	f->fontVersion = 0;
+	f->height = HEIGHT;
+	f->total_glyphs = GLYPHS;
+	f->first_glyph = FIRST;
+	f->widths_table = offsetof( TEST_FONT, widths );
+	f->bitmaps = offsetof( TEST_FONT, bitmaps );
+	f->baseline_height = HEIGHT - 1;
+
+	for ( int i = 0; i < GLYPHS; i++ ) {
+		uint8_t *rows = test_font.data[i];
+
+		test_font.widths[i] = i ? WIDTH : 4;
+		test_font.bitmaps[i] = offsetof( TEST_FONT, data ) + i * HEIGHT;
+		rows[0] = rows[HEIGHT - 1] = i ? 0xF8 : 0;
+		for ( int y = 1; y < HEIGHT - 1; y++ ) rows[y] = i ? 0x88 | ( ( FIRST + i ) >> ( y - 1 ) & 1 ) << 5 : 0;
+	}
+}
+
+// VDU bytes sent between measure_start() and measure_end()
+
+static uint32_t sent;
+
+static void measure_start( void )
+{
+	vdp_capture_start( NULL, 0, NULL, 0 );
+}
+
+static void measure_end( void )
+{
+	vdp_capture_stop();
+	sent = vdp_capture_total();
+}
+
+int main( void )
+{
+	char buf[16];
+	unsigned int w, w_kern, cached, drawn;
+	uint24_t x;
+
+	vdp_mode( 8 );
+	vdp_clear_screen();
+	make_font();
+
+	// Upload - each glyph's bitmap is sent once, when the font is set
+
+	measure_start();
+	check( "SetFont", fontlib_SetFont( &test_font.font, 0 ) );
+	measure_end();
+	check( "glyph upload", sent > (uint32_t)GLYPHS * HEIGHT );
+	printf( "  %lu bytes for %d glyphs\r\n", sent, GLYPHS );
+
+	fontlib_SetColors( 15, 0 );
+	fontlib_SetTransparency( true );
+
+	// Kerning
+
+	w = fontlib_GetStringWidth( "AVATAR" );
+	check( "width without kerning", w == 5 * WIDTH + WIDTH );
+	fontlib_SetKerning( kern, sizeof( kern ) / sizeof( kern[0] ) );
+	w_kern = fontlib_GetStringWidth( "AVATAR" );
+	check( "width with kerning", w_kern == w - 2 - 2 - 1 );
+	check( "pairs not in the table", fontlib_GetStringWidth( "RAT" ) == 3 * WIDTH );
+
+	fontlib_SetCursorPosition( 8, 40 );
+	x = fontlib_DrawString( "AVATAR" );
+	check( "DrawString advance", x == 8 + w_kern );
+
+	// Cached strings - drawn with one buffer call rather than a plot per glyph
+
+	cached = fontlib_CacheString( 0, "AVATAR" );
+	check( "CacheString width", cached == w_kern );
+
+	fontlib_SetCursorPosition( 8, 56 );
+	measure_start();
+	fontlib_DrawString( "AVATAR" );
+	measure_end();
+	drawn = sent;
+
+	fontlib_SetCursorPosition( 8, 72 );
+	measure_start();
+	x = fontlib_DrawCachedString( 0 );
+	measure_end();
+	check( "DrawCachedString advance", x == 8 + cached );
+	check( "DrawCachedString sends less", sent < drawn );
+	printf( "  %u bytes drawn, %lu cached\r\n", drawn, sent );
+
+	fontlib_FreeCachedString( 0 );
+	fontlib_SetCursorPosition( 8, 88 );
+	check( "freed slot draws nothing", fontlib_DrawCachedString( 0 ) == 8 );
+	check( "bad slot", fontlib_CacheString( FONTLIB_CACHE_SLOTS, "A" ) == 0 );
+
+	// Numbers
+
+	fontlib_SetKerning( NULL, 0 );
+	snprintf( buf, sizeof( buf ), "%d", INT_MIN );
+	fontlib_SetCursorPosition( 8, 104 );
+	fontlib_DrawInt( INT_MIN, 1 );
+	check( "DrawInt(INT_MIN)", fontlib_GetCursorX() == 8 + fontlib_GetStringWidth( buf ) );
+	fontlib_SetCursorPosition( 8, 120 );
+	fontlib_DrawInt( -42, 5 );
+	check( "DrawInt(-42, 5)", fontlib_GetCursorX() == 8 + 5 * WIDTH );
+
+	vdp_cursor_tab( 18, 0 );
+	printf( "%s\r\n", failed ? "FAILED" : "All passed" );
+	return 0;
+}
@@ -0,0 +1,55 @@
+/*
+ * Title:			i2c - tests batched I2C transfers
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <mos_api.h>
+#include <agon/i2c.h>
+
+int main( int argc, char *argv[] )
+{
+	i2c_open( I2C_SPEED_115200 );
+
+	if ( argc < 4 ) {
+		int addr, found = 0;
+
+		printf( "Scanning I2C bus\n" );
+		for ( addr = 0x08; addr < 0x78; addr++ ) {
+			I2C_SEG probe = { addr, I2C_SEG_WRITE, 0, NULL };
+
+			if ( i2c_transfer( &probe, 1 ) == RET_OK ) {
+				printf( "Device at 0x%02X\n", addr );
+				found++;
+			}
+		}
+		printf( "%d device(s) found\n", found );
+	}
+	else {
+		uint8_t addr = strtol( argv[1], NULL, 0 );
+		uint8_t reg = strtol( argv[2], NULL, 0 );
+		uint24_t count = strtol( argv[3], NULL, 0 );
+		uint8_t *buf = malloc( count );
+		uint8_t ret;
+		uint24_t i;
+
+		if ( !buf ) {
+			printf( "Out of memory\n" );
+			return 1;
+		}
+		ret = i2c_read_regs( addr, reg, buf, count );
+		if ( ret != RET_OK ) printf( "Error %d\n", ret );
+		else {
+			for ( i = 0; i < count; i++ ) printf( i % 16 == 15 ? "%02X\n" : "%02X ", buf[i] );
+			if ( count % 16 ) printf( "\n" );
+		}
+		free( buf );
+	}
+
+	i2c_close();
+	return 0;
+}
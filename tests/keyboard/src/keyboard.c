@@ -0,0 +1,53 @@
+/*
+ * Title:			keyboard - tests keypadc style keyboard snapshot
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+#include <agon/vdp_key.h>
+
+static const struct { uint8_t code; const char *name; } keys[] = {
+	{ KB_KEY_UP, "Up" }, { KB_KEY_DOWN, "Down" }, { KB_KEY_LEFT, "Left" },
+	{ KB_KEY_RIGHT, "Right" }, { KB_KEY_SPACE, "Space" }
+};
+
+int main( void )
+{
+	volatile SYSVAR *sv = vdp_vdu_init();
+	uint32_t tick;
+	int held, prev_held = 0;
+
+	if ( vdp_key_init() == -1 ) return 1;
+
+	printf( "Keyboard snapshot demo - press Escape to exit\r\n\r\n" );
+
+	kb_Reset();
+	while ( true ) {
+		tick = sv->time;
+		while ( sv->time == tick );							// one scan per vblank
+
+		kb_Scan();
+		if ( kb_IsPressed( KB_KEY_ESCAPE ) ) break;
+
+		for ( size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++ ) {
+			if ( kb_IsPressed( keys[i].code ) ) printf( "%s pressed\r\n", keys[i].name );
+			if ( kb_IsReleased( keys[i].code ) ) printf( "%s released\r\n", keys[i].name );
+		}
+		for ( char c = 'a'; c <= 'z'; c++ ) {
+			if ( kb_IsPressed( KB_KEY_LETTER( c ) ) ) printf( "%c pressed\r\n", c );
+			if ( kb_IsReleased( KB_KEY_LETTER( c ) ) ) printf( "%c released\r\n", c );
+		}
+
+		held = 0;
+		for ( int i = 0; i < 32; i++ )
+			for ( uint8_t b = kb_Data[i]; b; b &= b - 1 ) held++;
+		if ( held != prev_held ) printf( "%d keys held\r\n", held );
+		prev_held = held;
+	}
+	return 0;
+}
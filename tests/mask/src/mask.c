@@ -0,0 +1,124 @@
+/*
+ * Title:			mask - tests pixel accurate collision masks
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+#include <agon/vdp_mask.h>
+
+#define SIZE	16
+#define RING_FILE	"ring.rgba"
+
+static uint32_t ring[SIZE * SIZE];
+
+// A ring 2 pixels wide - transparent in the middle and the corners
+
+static void make_ring( void )
+{
+	int x, y;
+
+	for ( y = 0; y < SIZE; y++ ) {
+		for ( x = 0; x < SIZE; x++ ) {
+			int dx = 2 * x - SIZE + 1, dy = 2 * y - SIZE + 1;
+			int r2 = dx * dx + dy * dy;
+
+			ring[y * SIZE + x] = r2 <= 15 * 15 && r2 >= 11 * 11 ? 0xFF00FFFFUL : 0;
+		}
+	}
+}
+
+// Write the ring to a file and load it as bitmap 1 with vdp_load_bitmap_file(), capturing its
+// mask as it's sent - it must match the one built from the pixels in RAM
+
+static bool capture_ring( const VDP_MASK *expected )
+{
+	VDP_MASK captured;
+	FILE *fp = fopen( RING_FILE, "wb" );
+	bool ok;
+
+	if ( !fp ) return false;
+	fwrite( ring, sizeof( uint32_t ), SIZE * SIZE, fp );
+	fclose( fp );
+
+	vdp_mask_capture( &captured, 1 );
+	vdp_select_bitmap( 1 );
+	ok = vdp_load_bitmap_file( RING_FILE, SIZE, SIZE ) == 0 && captured.bits &&
+		 captured.width == SIZE && captured.height == SIZE &&
+		 !memcmp( captured.bits, expected->bits, SIZE * expected->stride );
+	vdp_mask_free( &captured );
+	mos_del( RING_FILE );
+	return ok;
+}
+
+static void print_masks( const char *fname )
+{
+	static VDP_MASK masks[32];
+	int n, x, y;
+
+	n = vdp_mask_load( fname, masks, 32 );
+	if ( n < 0 ) {
+		printf( "Can't load %s\r\n", fname );
+		return;
+	}
+	for ( int i = 0; i < n; i++ ) {
+		printf( "Mask %d: %dx%d\r\n", i, masks[i].width, masks[i].height );
+		for ( y = 0; y < masks[i].height; y++ ) {
+			for ( x = 0; x < masks[i].width; x++ )
+				putchar( masks[i].bits[y * masks[i].stride + ( x >> 3 )] & ( 0x80 >> ( x & 7 ) ) ? '#' : '.' );
+			printf( "\r\n" );
+		}
+		vdp_mask_free( &masks[i] );
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	VDP_MASK mask = { 0 };
+	uint32_t start;
+	int i, x, hits = 0;
+
+	if ( argc > 1 ) {
+		print_masks( argv[1] );
+		return 0;
+	}
+
+	make_ring();
+	if ( vdp_mask_from_rgba( &mask, ring, SIZE, SIZE ) ) {
+		printf( "Out of memory\r\n" );
+		return 1;
+	}
+
+	vdp_mode( 8 );
+	vdp_clear_screen();
+	vdp_select_bitmap( 0 );
+	vdp_load_bitmap( SIZE, SIZE, ring );
+	printf( "mask captured from vdp_load_bitmap_file: %s\r\n", capture_ring( &mask ) ? "ok" : "FAIL" );
+
+	// Ring 2 starts clear of ring 1 and moves right across it, 3 pixels down
+
+	for ( x = 100 - SIZE - 2; x <= 100 + SIZE + 2; x += 2 ) {
+		bool box = x < 100 + SIZE && x + SIZE > 100;
+		bool pixels = vdp_mask_overlap( &mask, 100, 100, &mask, x, 103 );
+
+		vdp_clear_graphics();
+		vdp_draw_bitmap( 100, 100 );
+		vdp_draw_bitmap( x, 103 );
+		printf( "x %3d: box %d, mask %d\r\n", x - 100, box, pixels );
+		start = getsysvar_time();
+		while ( getsysvar_time() - start < 25 );
+	}
+
+	start = getsysvar_time();
+	for ( i = 0; i < 1000; i++ ) hits += vdp_mask_overlap( &mask, 100, 100, &mask, 100 + ( i & 15 ), 100 + ( ( i >> 4 ) & 15 ) );
+	printf( "1000 mask tests in %lu cs (%d hits)\r\n", getsysvar_time() - start, hits );
+
+	vdp_mask_free( &mask );
+	return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * Title:			mosacct - tests MOS call accounting
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <mos_api.h>
+#include <mos_acct.h>
+
+#define TEST_FILE	"mosacct.dat"
+#define TEST_SIZE	2048
+
+static char buf[TEST_SIZE];
+
+// Print the calls and time since the last reset, then reset
+
+static void report( const char *title )
+{
+	MOS_ACCT acct[MOS_ACCT_SLOTS];
+	uint24_t calls = 0;
+	uint32_t ticks = 0;
+
+	mos_acct_read( acct );
+	printf( "\r\n%s\r\n", title );
+	for ( uint8_t slot = 0; slot < MOS_ACCT_SLOTS; slot++ ) {
+		if ( !acct[slot].count || slot == MOS_ACCT_OUTCHAR ) continue;
+		printf( "  %-8s %6u calls %8lu us\r\n", mos_acct_name( slot ), acct[slot].count, MOS_ACCT_TICKS_TO_US( acct[slot].ticks ) );
+		calls += acct[slot].count;
+		ticks += acct[slot].ticks;
+	}
+	printf( "  total    %6u calls %8lu us\r\n", calls, MOS_ACCT_TICKS_TO_US( ticks ) );
+	mos_acct_reset();
+}
+
+int main( void )
+{
+	FILE *f;
+	int i;
+
+	for ( i = 0; i < TEST_SIZE; i++ ) buf[i] = 'A' + i % 26;
+
+	printf( "MOS call accounting\r\n" );
+	mos_acct_reset();
+
+	f = fopen( TEST_FILE, "wb" );
+	if ( !f ) return 1;
+	for ( i = 0; i < TEST_SIZE; i++ ) fputc( buf[i], f );
+	fclose( f );
+	f = fopen( TEST_FILE, "rb" );
+	if ( !f ) return 1;
+	for ( i = 0; i < TEST_SIZE; i++ ) buf[i] = fgetc( f );
+	fclose( f );
+	report( "fputc / fgetc" );
+
+	f = fopen( TEST_FILE, "wb" );
+	if ( !f ) return 1;
+	fwrite( buf, 1, TEST_SIZE, f );
+	fclose( f );
+	f = fopen( TEST_FILE, "rb" );
+	if ( !f ) return 1;
+	fread( buf, 1, TEST_SIZE, f );
+	fclose( f );
+	report( "fwrite / fread" );
+
+	mos_del( TEST_FILE );
+
+	for ( i = 0; i < 100; i++ ) getsysvar_time();
+	report( "100 x getsysvar_time" );
+
+	printf( "\r\nThe calls from here on are written to %s\r\n", MOS_ACCT_FILE );
+	return 0;
+}
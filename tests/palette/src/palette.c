@@ -0,0 +1,77 @@
+/*
+ * Title:			palette - tests palette cycling and fades
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+#include <agon/vdp_palette.h>
+
+#define WATER		16					// colours 16 - 31
+#define FLASH		32					// box colour, 33 is the other flash colour
+
+static uint8_t saved[34 * 3];
+
+static void wait_frame( void )
+{
+	uint8_t t = (uint8_t)getsysvar_time();
+
+	while ( (uint8_t)getsysvar_time() == t );
+}
+
+static void frames( int n )
+{
+	while ( n-- ) {
+		int sent;
+
+		wait_frame();
+		sent = vdp_pal_update();
+		vdp_cursor_home();
+		printf( "%2d colours sent ", sent );
+	}
+}
+
+int main( void )
+{
+	int i;
+
+	vdp_mode( 8 );								// 64 colours
+	vdp_get_scr_dims( true );
+	vdp_logical_scr_dims( false );
+	vdp_clear_screen();
+	vdp_pal_init( 0 );
+
+	vdp_pal_set( 15, 255, 255, 255 );			// text
+	for ( i = 0; i < 16; i++ ) {
+		int shade = i < 8 ? i : 15 - i;
+
+		vdp_pal_set( WATER + i, 0, 40 + shade * 20, 100 + shade * 20 );
+		vdp_gcol( 0, WATER + i );
+		vdp_move_to( 0, 40 + i * 10 );
+		vdp_filled_rect( 319, 49 + i * 10 );
+	}
+	vdp_pal_set( FLASH, 255, 0, 0 );
+	vdp_pal_set( FLASH + 1, 255, 255, 0 );
+	vdp_gcol( 0, FLASH );
+	vdp_move_to( 140, 90 );
+	vdp_filled_rect( 180, 130 );
+
+	vdp_pal_cycle( WATER, WATER + 15, 3, 1 );
+	vdp_pal_cycle( FLASH, FLASH + 1, 15, 1 );
+	frames( 300 );
+
+	// Fade everything to black and back
+
+	for ( i = 0; i < 34; i++ ) vdp_pal_get( i, &saved[i * 3], &saved[i * 3 + 1], &saved[i * 3 + 2] );
+	vdp_pal_fade( 0, 33, NULL, 60 );
+	frames( 70 );
+	vdp_pal_fade( 0, 33, saved, 60 );
+	frames( 120 );
+
+	vdp_mode( 8 );
+	return 0;
+}
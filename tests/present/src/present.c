@@ -0,0 +1,82 @@
+/*
+ * Title:			present - tests double buffered presentation with damage rectangles
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+#include <agon/vdp_present.h>
+
+#define BOXES		8
+#define SIZE		20
+
+typedef struct { int x, y, dx, dy, colour; } BOX;
+
+static BOX boxes[BOXES];
+static char batch[256];
+
+static void draw_box( const BOX *b )
+{
+	vdp_gcol( 0, b->colour );
+	vdp_move_to( b->x, b->y );
+	vdp_filled_rect( b->x + SIZE - 1, b->y + SIZE - 1 );
+}
+
+int main( void )
+{
+	const VDP_RECT *rects;
+	int w, h, i, n;
+	uint32_t start;
+
+	vdp_present_init( 136, batch, sizeof( batch ) );
+	vdp_logical_scr_dims( false );
+	vdp_cursor_enable( false );
+	w = getsysvar_scrwidth();
+	h = getsysvar_scrheight();
+
+	srand( 1 );
+	for ( i = 0; i < BOXES; i++ ) {
+		boxes[i].x = rand() % ( w - SIZE );
+		boxes[i].y = rand() % ( h - SIZE );
+		boxes[i].dx = 1 + i % 3;
+		boxes[i].dy = 1 + ( i + 1 ) % 3;
+		boxes[i].colour = 9 + i % 6;
+	}
+
+	start = getsysvar_time();
+	while ( !getsysvar_vkeydown() ) {
+		// Redraw the damaged areas of the back buffer
+
+		n = vdp_present_damage( &rects );
+		vdp_gcol( 0, 0 );
+		for ( i = 0; i < n; i++ ) {
+			vdp_move_to( rects[i].x0, rects[i].y0 );
+			vdp_filled_rect( rects[i].x1, rects[i].y1 );
+		}
+		for ( i = 0; i < BOXES; i++ ) draw_box( &boxes[i] );
+		vdp_present();
+
+		// Move the boxes, damaging where they were and where they are
+
+		for ( i = 0; i < BOXES; i++ ) {
+			BOX *b = &boxes[i];
+
+			vdp_damage( b->x, b->y, b->x + SIZE - 1, b->y + SIZE - 1 );
+			if ( b->x + b->dx < 0 || b->x + b->dx > w - SIZE ) b->dx = -b->dx;
+			if ( b->y + b->dy < 0 || b->y + b->dy > h - SIZE ) b->dy = -b->dy;
+			b->x += b->dx;
+			b->y += b->dy;
+			vdp_damage( b->x, b->y, b->x + SIZE - 1, b->y + SIZE - 1 );
+		}
+	}
+
+	vdp_present_end();
+	vdp_mode( 0 );
+	printf( "%lu frames in %lu cs\r\n", (unsigned long)vdp_present_frames(), getsysvar_time() - start );
+	return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Title:			serial - tests interrupt driven UART1 driver with a loopback
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <mos_api.h>
+#include <agon/serial.h>
+
+#define TEST_BYTES	65536L
+
+int main( int argc, char *argv[] )
+{
+	UART settings = { 115200, 8, 1, 0, 0, 0 };
+	uint8_t buf[64];
+	uint24_t sent = 0, received = 0, bad = 0;
+	uint32_t start, elapsed;
+	char line[40];
+	FILE *fp;
+
+	if ( argc > 1 ) settings.baudRate = atoi( argv[1] );
+	if ( argc > 2 ) settings.flowcontrol = 1;
+
+	if ( ser_open( &settings ) ) {
+		printf( "Cannot open UART1 at %d baud\n", settings.baudRate );
+		return 1;
+	}
+	printf( "UART1 %d baud, flow control %s\n", settings.baudRate, settings.flowcontrol ? "on" : "off" );
+
+	start = getsysvar_time();
+	while ( received < TEST_BYTES ) {
+		if ( sent < TEST_BYTES ) {
+			int n = ser_tx_free();
+			int i;
+
+			if ( n > (int)sizeof( buf ) ) n = sizeof( buf );
+			if ( n > (int)( TEST_BYTES - sent ) ) n = TEST_BYTES - sent;
+			for ( i = 0; i < n; i++ ) buf[i] = ( sent + i ) & 0xFF;
+			sent += ser_write( buf, n );
+		}
+		if ( ser_available() ) {
+			int n = ser_read( buf, sizeof( buf ) );
+			int i;
+
+			for ( i = 0; i < n; i++ ) if ( buf[i] != ( ( received + i ) & 0xFF ) ) bad++;
+			received += n;
+		}
+		if ( getsysvar_time() - start > 3000 ) break;		// 30 second timeout
+	}
+	elapsed = getsysvar_time() - start;
+
+	printf( "Sent %u, received %u, mismatched %u, lost %u\n", sent, received, bad, ser_errors() );
+	if ( elapsed ) printf( "%lu bytes/second\n", received * 100L / elapsed );
+
+	fp = ser_fopen( "w" );
+	fprintf( fp, "Hello from UART1 %d\n", settings.baudRate );
+	fgets( line, sizeof( line ), fp );
+	printf( "Echo: %s", line );
+
+	ser_close();
+	return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Title:			task - tests cooperative tasks
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <mos_api.h>
+#include <agon/task.h>
+#include <vdp_vdu.h>
+
+typedef struct {
+	const char *name;
+	uint24_t ticks;
+	int count;
+} COUNTER;
+
+static void counter( void *arg )
+{
+	COUNTER *c = arg;
+	int i;
+
+	for ( i = 1; i <= c->count; i++ ) {
+		printf( "%s %d (task %d)\r\n", c->name, i, task_id() );
+		task_sleep_ticks( c->ticks );
+	}
+}
+
+static void screen_query( void *arg )
+{
+	(void)arg;
+
+	task_vdp_request( vdp_pflag_mode );
+	vdp_get_scr_dims( false );
+	task_wait_vdp( vdp_pflag_mode );
+
+	printf( "Screen %d x %d, %d colours\r\n", getsysvar_scrwidth(), getsysvar_scrheight(), getsysvar_scrColours() );
+}
+
+int main( void )
+{
+	static COUNTER fast = { "fast", 25, 8 };
+	static COUNTER slow = { "slow", 100, 2 };
+	uint24_t spins = 0;
+
+	if ( task_spawn( counter, &fast, 0 ) < 0 || task_spawn( counter, &slow, 0 ) < 0 ||
+		 task_spawn( screen_query, NULL, 512 ) < 0 ) {
+		printf( "Out of memory\r\n" );
+		return 1;
+	}
+
+	while ( task_count() > 1 ) {
+		spins++;
+		task_yield();
+	}
+
+	printf( "main ran %u times while the tasks waited\r\n", spins );
+	return 0;
+}
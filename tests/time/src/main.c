@@ -44,6 +44,22 @@ int main( void )
 
 	printf( "Time from RTC to complete %d loops: %.0f seconds\r\n", loops, difftime( time2, time1 ) );
 
+	// time() is served from a cached RTC, so it can be called at a high rate
+
+	struct timeval tv;
+	long calls = 0;
+
+	ticks1 = clock();
+	while ( clock() - ticks1 < CLOCKS_PER_SEC ) {
+		time( NULL );
+		calls++;
+	}
+	printf( "\r\ntime() calls per second: %ld\r\n", calls );
+
+	gettimeofday( &tv, NULL );
+	printf( "gettimeofday(): %lu.%06ld\r\n", tv.tv_sec, tv.tv_usec );
+
+	time_resync();
 	t = time(NULL);
 	printf( "The program finished at: %s\r\n", ctime( &t ) );
 	return 0;
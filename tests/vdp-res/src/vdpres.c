@@ -0,0 +1,102 @@
+/*
+ * Title:			vdpres - tests the VDP resource manager
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+#include <agon/vdp_res.h>
+
+#define SIZE		32
+#define IMAGES		5
+#define IMAGE_BYTES	( SIZE * SIZE * 4 )
+
+static uint32_t image[SIZE * SIZE];
+static int ids[IMAGES];
+
+static void make_image( int n )
+{
+	int x, y;
+
+	for ( y = 0; y < SIZE; y++ ) {
+		for ( x = 0; x < SIZE; x++ ) {
+			uint8_t r = ( n & 1 ) ? x * 8 : 0, g = ( n & 2 ) ? y * 8 : 0, b = ( n & 4 ) ? 255 : ( x ^ y ) * 8;
+
+			image[y * SIZE + x] = 0xFF000000UL | (uint32_t)b << 16 | (uint32_t)g << 8 | r;
+		}
+	}
+}
+
+static int upload( int n )
+{
+	uint32_t start = getsysvar_time();
+	int id;
+
+	make_image( n );
+	id = vdp_res_bitmap( image, IMAGE_BYTES, SIZE, SIZE, 0 );
+	printf( "image %d -> id %d in %lu cs, %lu bytes used\r\n", n, id, getsysvar_time() - start, vdp_res_used() );
+	return id;
+}
+
+static void draw( int row )
+{
+	int n;
+
+	for ( n = 0; n < IMAGES; n++ ) {
+		if ( ids[n] >= 0 && vdp_res_resident( ids[n] ) ) {
+			vdp_adv_select_bitmap( ids[n] );
+			vdp_draw_bitmap( n * ( SIZE + 8 ), 200 + row * ( SIZE + 8 ) );
+		}
+	}
+}
+
+int main( void )
+{
+	int n;
+
+	vdp_mode( 8 );
+	vdp_clear_screen();
+	vdp_res_init( 0x1000, 16, 3 * IMAGE_BYTES );
+
+	for ( n = 0; n < IMAGES - 1; n++ ) ids[n] = upload( n );
+	ids[IMAGES - 1] = -1;
+	printf( "image 3 doesn't fit while 0-2 are in use: %s\r\n", ids[3] < 0 ? "ok" : "FAIL" );
+	draw( 0 );
+
+	printf( "upload image 0 again:\r\n" );
+	upload( 0 );
+	vdp_res_release( ids[0] );
+
+	for ( n = 0; n < 3; n++ ) vdp_res_release( ids[n] );
+	vdp_res_touch( ids[0] );
+
+	printf( "release all, then upload 3 and 4 (evicts 1 and 2):\r\n" );
+	ids[3] = upload( 3 );
+	ids[4] = upload( 4 );
+	printf( "resident ids:" );
+	for ( n = 0x1000; n < 0x1010; n++ ) if ( vdp_res_resident( n ) ) printf( " %d", n );
+	printf( "\r\n" );
+
+	// The IDs of the evicted images now belong to images 3 and 4
+
+	ids[1] = ids[2] = -1;
+	draw( 1 );
+
+	// With only 4 IDs and room for all 5 images, the fifth takes the least recently used ID
+
+	vdp_res_init( 0x1000, 4, IMAGES * IMAGE_BYTES );
+	printf( "5 images, 4 IDs:\r\n" );
+	for ( n = 0; n < IMAGES; n++ ) {
+		ids[n] = upload( n );
+		vdp_res_release( ids[n] );
+	}
+	printf( "image 4 took image 0's id: %s\r\n", ids[4] == 0x1000 && ids[0] == 0x1000 ? "ok" : "FAIL" );
+	ids[0] = -1;
+	draw( 2 );
+
+	return 0;
+}
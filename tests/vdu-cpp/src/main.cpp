@@ -0,0 +1,53 @@
+/*
+ * Title:			vducpp - tests compile time VDU packets
+ * Created:			18/10/2026
+ *
+ * Modinfo:
+ */
+
+#include <stdio.h>
+#include <mos_api.h>
+#include <agon/vdp_vdu.h>
+#include <agon/vdu.hpp>
+
+using namespace agon;
+
+static constexpr auto setup = vdu::mode( 8 ) + vdu::clear_screen() + vdu::cursor_enable( false ) +
+							  vdu::graphics_colour( 0, 3 );
+
+static void draw_packets( int step )
+{
+	vdu::Batch<> batch;
+
+	for ( int x = 0; x < 320; x += step ) batch << vdu::move_to( x, 0 ) << vdu::line_to( x, 239 );
+	for ( int y = 0; y < 240; y += step ) batch << vdu::move_to( 0, y ) << vdu::line_to( 319, y );
+	for ( int x = 20; x < 320; x += 40 ) batch << vdu::move_to( x, 120 ) << vdu::circle_radius( 15, 0 );
+}
+
+static void draw_functions( int step )
+{
+	for ( int x = 0; x < 320; x += step ) { vdp_move_to( x, 0 ); vdp_line_to( x, 239 ); }
+	for ( int y = 0; y < 240; y += step ) { vdp_move_to( 0, y ); vdp_line_to( 319, y ); }
+	for ( int x = 20; x < 320; x += 40 ) { vdp_move_to( x, 120 ); vdp_circle_radius( 15, 0 ); }
+}
+
+int main( void )
+{
+	uint32_t start, packets, functions;
+
+	vdu::send( setup );
+
+	start = getsysvar_time();
+	draw_packets( 10 );
+	packets = getsysvar_time() - start;
+
+	vdu::send( vdu::clear_graphics() );
+
+	start = getsysvar_time();
+	draw_functions( 10 );
+	functions = getsysvar_time() - start;
+
+	vdu::send( vdu::cursor_enable( true ) + vdu::cursor_home() );
+	printf( "vdu.hpp %lu cs, vdp_vdu.h %lu cs\r\n", packets, functions );
+	return 0;
+}
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+#
+# Title:		agon-pgo - selects the source files to build for speed in "make pgo-use"
+# Created:		18/10/2026
+#
+# Reads the call counts written by the profile runtime (libc/pgo.c) in one or more training runs,
+# maps the function addresses to names with the map file from "make pgo-instrument", then finds
+# the source files defining the functions that make up the given percentage of all calls.
+#
+# usage: agon-pgo.py --map bin/pgo/NAME.map --objdir obj/pgo-instrument [--hot 90] [--stamp FILE] [-v] files.prf...
+#
+# Prints the source file names (as used in the makefile) on one line. With --stamp they are also
+# written to FILE, but only if they differ from what it holds, so that the makefile can rebuild
+# the files whose flags have changed when its date does.
+
+import argparse
+import bisect
+import os
+import re
+import struct
+import sys
+
+MAGIC = b"AGPGO1"
+
+
+def read_profile(path, counts):
+	with open(path, "rb") as f:
+		data = f.read()
+	if data[:6] != MAGIC:
+		sys.exit("agon-pgo: %s is not a profile file" % path)
+	entries = int.from_bytes(data[6:9], "little")
+	pos = 9
+	for _ in range(entries):
+		if pos + 7 > len(data):
+			break
+		fn = int.from_bytes(data[pos:pos + 3], "little")
+		(count,) = struct.unpack_from("<I", data, pos + 3)
+		counts[fn] = counts.get(fn, 0) + count
+		pos += 7
+
+
+def read_map(path):
+	symbols = {}
+	with open(path) as f:
+		for line in f:
+			m = re.match(r"^\s*(\S+)\s*=\s*(?:\$|0x)?([0-9A-Fa-f]{6})\b", line)
+			if m:
+				symbols[int(m.group(2), 16)] = m.group(1)
+	return symbols
+
+
+# Find which compiled .src file defines each symbol - the .src tree mirrors the source tree
+
+def read_objdir(objdir):
+	defined = {}
+	for root, _, files in os.walk(objdir):
+		for name in files:
+			if not name.endswith(".src"):
+				continue
+			path = os.path.join(root, name)
+			source = os.path.relpath(path, objdir)[:-len(".src")]
+			source = source.replace("_..", "..").replace(os.sep, "/")
+			with open(path, errors="replace") as f:
+				for line in f:
+					m = re.match(r"^\s*(?:public|private)\s+(\S+)", line)
+					if m:
+						defined.setdefault(m.group(1), source)
+	return defined
+
+
+def main():
+	parser = argparse.ArgumentParser(description="select hot source files from Agon profiles")
+	parser.add_argument("--map", required=True, help="map file from the instrumented build")
+	parser.add_argument("--objdir", required=True, help="object directory of the instrumented build")
+	parser.add_argument("--hot", type=float, default=90.0, help="percentage of calls to cover")
+	parser.add_argument("--stamp", help="file to hold the list, rewritten only when it changes")
+	parser.add_argument("-v", "--verbose", action="store_true", help="list hot functions on stderr")
+	parser.add_argument("profiles", nargs="*")
+	args = parser.parse_args()
+
+	counts = {}
+	for path in args.profiles:
+		read_profile(path, counts)
+	hot_files = find_hot_files(args, counts) if counts else []
+	line = " ".join(hot_files)
+
+	if args.stamp:
+		try:
+			with open(args.stamp) as f:
+				old = f.read()
+		except OSError:
+			old = None
+		if old != line + "\n":
+			os.makedirs(os.path.dirname(args.stamp) or ".", exist_ok=True)
+			with open(args.stamp, "w") as f:
+				f.write(line + "\n")
+
+	print(line)
+
+
+def find_hot_files(args, counts):
+	symbols = read_map(args.map)
+	addresses = sorted(symbols)
+	defined = read_objdir(args.objdir)
+
+	# Static functions are not in the map, so use the nearest symbol below the address -
+	# the linker keeps each file's functions together
+
+	by_name = {}
+	for fn, count in counts.items():
+		i = bisect.bisect_right(addresses, fn) - 1
+		name = symbols[addresses[i]] if i >= 0 else "?"
+		by_name[name] = by_name.get(name, 0) + count
+
+	total = sum(by_name.values())
+	hot_files = []
+	covered = 0
+	for name, count in sorted(by_name.items(), key=lambda item: -item[1]):
+		if covered * 100.0 >= total * args.hot:
+			break
+		covered += count
+		source = defined.get(name)
+		if args.verbose:
+			print("%-32s %10d  %s" % (name, count, source or "(library)"), file=sys.stderr)
+		if source and source not in hot_files:
+			hot_files.append(source)
+	return hot_files
+
+
+if __name__ == "__main__":
+	main()
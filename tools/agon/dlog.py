@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# Title:		dlog - prints a binary log written by agon/dlog.h
+# Created:		18/10/2026
+#
+# The log holds the address of each format string and the raw arguments. The format strings
+# are read from the program's .bin, which is located in memory with the address of the
+# DLOG_MARKER string given in the log header. %s arguments pointing into the program are read
+# the same way, and with the .map file %p arguments are shown as symbol+offset.
+#
+# usage: dlog.py --bin bin/NAME.bin [--map bin/NAME.map] [--raw] log.dlg
+#
+# The .bin must be the uncompressed one (COMPRESSED = NO) from the same build as the log.
+
+import argparse
+import bisect
+import re
+import struct
+import sys
+
+MAGIC = b"AGDL\x01"
+MARKER = b"AGDL string table\x00"
+INT, LONG, FLOAT, PTR = range(4)
+ARG_SIZE = [3, 4, 4, 3]
+
+# printf conversion: flags, width, precision, length, conversion
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXcsfFeEgGpn%])")
+
+
+class Image:
+	def __init__(self, data, base):
+		self.data = data
+		self.base = base
+
+	def contains(self, addr):
+		return self.base <= addr < self.base + len(self.data)
+
+	def string(self, addr):
+		if not self.contains(addr):
+			return None
+		start = addr - self.base
+		end = self.data.find(b"\x00", start)
+		if end < 0:
+			end = len(self.data)
+		return self.data[start:end].decode("latin-1")
+
+
+def read_map(path):
+	symbols = {}
+	with open(path) as f:
+		for line in f:
+			m = re.match(r"^\s*(\S+)\s*=\s*(?:\$|0x)?([0-9A-Fa-f]{6})\b", line)
+			if m:
+				symbols[int(m.group(2), 16)] = m.group(1)
+	return symbols
+
+
+def signed(value, bits):
+	if value & (1 << (bits - 1)):
+		value -= 1 << bits
+	return value
+
+
+# Format one record as printf would - args is a list of (type, value)
+
+def format_record(fmt, args, image, symbols):
+	out = []
+	pos = 0
+	queue = list(args)
+
+	def take():
+		return queue.pop(0) if queue else (INT, 0)
+
+	for m in SPEC.finditer(fmt):
+		out.append(fmt[pos:m.start()])
+		pos = m.end()
+		flags, width, precision, length, conv = m.groups()
+		if conv == "%":
+			out.append("%")
+			continue
+		if width == "*":
+			width = str(signed(take()[1], 24))
+		if precision == "*":
+			precision = str(signed(take()[1], 24))
+		spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+		kind, value = take()
+		bits = 32 if kind in (LONG, FLOAT) else 24
+
+		if conv in "di":
+			out.append((spec + "d") % signed(value, bits))
+		elif conv in "ouxX":
+			out.append((spec + conv) % value)
+		elif conv == "c":
+			out.append((spec + "c") % chr(value & 0xFF))
+		elif conv in "fFeEgG":
+			f = struct.unpack("<f", struct.pack("<I", value))[0] if kind == FLOAT else float(signed(value, bits))
+			out.append((spec + conv) % f)
+		elif conv == "s":
+			s = image.string(value)
+			out.append((spec + "s") % (s if s is not None else "<%06X>" % value))
+		elif conv == "p":
+			name = ""
+			if symbols:
+				addresses = sorted(symbols)
+				i = bisect.bisect_right(addresses, value) - 1
+				if i >= 0:
+					name = " (%s+%d)" % (symbols[addresses[i]], value - addresses[i])
+			out.append((spec + "s") % ("0x%06X%s" % (value, name)))
+		else:
+			out.append(m.group(0))
+	out.append(fmt[pos:])
+	return "".join(out)
+
+
+def main():
+	parser = argparse.ArgumentParser(description="print an Agon dlog binary log")
+	parser.add_argument("--bin", required=True, help="program binary (uncompressed)")
+	parser.add_argument("--map", help="map file, for %%p arguments")
+	parser.add_argument("--raw", action="store_true", help="also show the record addresses and arguments")
+	parser.add_argument("log")
+	args = parser.parse_args()
+
+	with open(args.log, "rb") as f:
+		log = f.read()
+	with open(args.bin, "rb") as f:
+		program = f.read()
+	if log[:5] != MAGIC:
+		sys.exit("dlog: %s is not a dlog file" % args.log)
+
+	marker_addr = int.from_bytes(log[5:8], "little")
+	offset = program.find(MARKER)
+	if offset < 0:
+		sys.exit("dlog: %s doesn't use dlog (or is compressed)" % args.bin)
+	image = Image(program, marker_addr - offset)
+	symbols = read_map(args.map) if args.map else None
+
+	pos = 8
+	while pos + 8 <= len(log):
+		fmt_addr = int.from_bytes(log[pos:pos + 3], "little")
+		time = int.from_bytes(log[pos + 3:pos + 6], "little")
+		count = log[pos + 6]
+		types = log[pos + 7]
+		pos += 8
+
+		record = []
+		for i in range(count):
+			kind = (types >> (i * 2)) & 3
+			size = ARG_SIZE[kind]
+			record.append((kind, int.from_bytes(log[pos:pos + size], "little")))
+			pos += size
+		if pos > len(log):
+			print("dlog: log ends part way through a record", file=sys.stderr)
+			break
+
+		if fmt_addr == 0:
+			text = "*** %d records dropped (ring full)" % (record[0][1] if record else 0)
+		else:
+			fmt = image.string(fmt_addr)
+			if fmt is None:
+				text = "<format %06X not in the program>" % fmt_addr
+			else:
+				text = format_record(fmt, record, image, symbols).rstrip("\r\n")
+		if args.raw:
+			text += "    [%06X %s]" % (fmt_addr, " ".join("%X" % v for _, v in record))
+		print("%8d.%02d  %s" % (time // 100, time % 100, text))
+
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+#
+# Title:		mkatlas - builds a sprite sheet atlas for vdp_atlas_load()
+# Created:		18/10/2026
+#
+# Frames can be PNG files (8-bit RGB, RGBA, grey or palette, non-interlaced) or raw .rgba files
+# (as used by vdp_load_sprite_bitmaps, needs --size). A directory argument adds its .png / .rgba
+# files in natural order (frame2 before frame10). Smaller frames are padded to the largest.
+#
+# --mask also writes the 1-bit collision masks of the frames for vdp_mask_load().
+#
+# usage: mkatlas.py [--size WxH] [--format rgba8888|rgba2222] [--mask ship.msk] -o ship.atl frames...
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+
+def natural_key(name):
+	return [int(t) if t.isdigit() else t.lower() for t in re.split(r"(\d+)", name)]
+
+
+def paeth(a, b, c):
+	p = a + b - c
+	pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+	if pa <= pb and pa <= pc:
+		return a
+	return b if pb <= pc else c
+
+
+def read_png(path):
+	with open(path, "rb") as f:
+		data = f.read()
+	if data[:8] != b"\x89PNG\r\n\x1a\n":
+		sys.exit("mkatlas: %s is not a PNG file" % path)
+
+	pos = 8
+	idat = b""
+	palette = []
+	trns = b""
+	while pos < len(data):
+		length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+		chunk = data[pos + 8:pos + 8 + length]
+		pos += 12 + length
+		if kind == b"IHDR":
+			width, height, depth, colour, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+		elif kind == b"PLTE":
+			palette = [tuple(chunk[i:i + 3]) for i in range(0, length, 3)]
+		elif kind == b"tRNS":
+			trns = chunk
+		elif kind == b"IDAT":
+			idat += chunk
+		elif kind == b"IEND":
+			break
+
+	channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}.get(colour)
+	if depth != 8 or interlace or channels is None:
+		sys.exit("mkatlas: %s - only 8-bit non-interlaced PNG files are supported" % path)
+
+	raw = zlib.decompress(idat)
+	stride = width * channels
+	prev = bytearray(stride)
+	pixels = []
+	pos = 0
+	for _ in range(height):
+		ftype = raw[pos]
+		line = bytearray(raw[pos + 1:pos + 1 + stride])
+		pos += 1 + stride
+		for i in range(stride):
+			a = line[i - channels] if i >= channels else 0
+			b = prev[i]
+			c = prev[i - channels] if i >= channels else 0
+			if ftype == 1:
+				line[i] = (line[i] + a) & 0xFF
+			elif ftype == 2:
+				line[i] = (line[i] + b) & 0xFF
+			elif ftype == 3:
+				line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+			elif ftype == 4:
+				line[i] = (line[i] + paeth(a, b, c)) & 0xFF
+		for x in range(width):
+			p = line[x * channels:(x + 1) * channels]
+			if colour == 0:
+				pixels.append((p[0], p[0], p[0], 255))
+			elif colour == 2:
+				pixels.append((p[0], p[1], p[2], 255))
+			elif colour == 3:
+				r, g, b = palette[p[0]]
+				pixels.append((r, g, b, trns[p[0]] if p[0] < len(trns) else 255))
+			elif colour == 4:
+				pixels.append((p[0], p[0], p[0], p[1]))
+			else:
+				pixels.append(tuple(p))
+		prev = line
+	return width, height, pixels
+
+
+def read_rgba(path, size):
+	if not size:
+		sys.exit("mkatlas: --size is needed for raw file %s" % path)
+	width, height = size
+	with open(path, "rb") as f:
+		data = f.read()
+	if len(data) < width * height * 4:
+		sys.exit("mkatlas: %s is smaller than %dx%d" % (path, width, height))
+	return width, height, [tuple(data[i:i + 4]) for i in range(0, width * height * 4, 4)]
+
+
+def frame_files(args):
+	files = []
+	for arg in args:
+		if os.path.isdir(arg):
+			names = [n for n in os.listdir(arg) if n.lower().endswith((".png", ".rgba"))]
+			files += [os.path.join(arg, n) for n in sorted(names, key=natural_key)]
+		else:
+			files.append(arg)
+	return files
+
+
+def encode(pixel, fmt):
+	r, g, b, a = pixel
+	if fmt == 0:
+		return bytes((r, g, b, a))
+	return bytes(((r >> 6) | (g >> 6) << 2 | (b >> 6) << 4 | (a >> 6) << 6,))
+
+
+def mask_rows(frame, width, height, alpha=0x80):
+	fw, fh, pixels = frame
+	stride = (width + 7) // 8
+	out = bytearray(stride * height)
+	for y in range(min(fh, height)):
+		for x in range(min(fw, width)):
+			if pixels[y * fw + x][3] >= alpha:
+				out[y * stride + x // 8] |= 0x80 >> (x & 7)
+	return out
+
+
+def main():
+	parser = argparse.ArgumentParser(description="build an Agon sprite atlas")
+	parser.add_argument("-o", "--output", required=True)
+	parser.add_argument("--size", help="WxH of raw .rgba frames")
+	parser.add_argument("--format", choices=("rgba8888", "rgba2222"), default="rgba8888")
+	parser.add_argument("--mask", help="also write collision masks to this file")
+	parser.add_argument("frames", nargs="+")
+	args = parser.parse_args()
+
+	size = tuple(int(v) for v in args.size.lower().split("x")) if args.size else None
+	fmt = 0 if args.format == "rgba8888" else 1
+
+	frames = []
+	for path in frame_files(args.frames):
+		if path.lower().endswith(".png"):
+			frames.append(read_png(path))
+		else:
+			frames.append(read_rgba(path, size))
+	if not frames:
+		sys.exit("mkatlas: no frames")
+
+	width = max(f[0] for f in frames)
+	height = max(f[1] for f in frames)
+	if width * height * (4 if fmt == 0 else 1) > 0xFFFF:
+		sys.exit("mkatlas: frames of %dx%d are over 64KB - use smaller frames or rgba2222" % (width, height))
+
+	out = bytearray(b"AGAT" + struct.pack("<BBHHH", 1, fmt, width, height, len(frames)))
+	blank = (0, 0, 0, 0)
+	for fw, fh, pixels in frames:
+		for y in range(height):
+			for x in range(width):
+				out += encode(pixels[y * fw + x] if x < fw and y < fh else blank, fmt)
+
+	with open(args.output, "wb") as f:
+		f.write(out)
+	print("%s: %d frames of %dx%d, %d bytes" % (args.output, len(frames), width, height, len(out)))
+
+	if args.mask:
+		mask = bytearray(b"AGMK" + struct.pack("<BBHHH", 1, 0, width, height, len(frames)))
+		for frame in frames:
+			mask += mask_rows(frame, width, height)
+		with open(args.mask, "wb") as f:
+			f.write(mask)
+		print("%s: %d masks, %d bytes" % (args.mask, len(frames), len(mask)))
+
+
+if __name__ == "__main__":
+	main()
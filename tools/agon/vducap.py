@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+#
+# Title:		vducap - decodes a VDU stream capture from vdp_capture_dump()
+# Created:		18/10/2026
+#
+# Prints the commands sent by count and bytes, and the bytes sent each frame. If the capture
+# kept the raw stream, it's decoded here in full (including the buffer command numbers and
+# audio commands the on-target counts group together), otherwise the counts made on the Agon
+# are shown.
+#
+# usage: vducap.py [--fps 60] [--frames] [--dump] capture.vdc
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"AGVC\x01"
+LINK_BYTES_PER_SEC = 1152000 // 10		# VDP link baud rate / 10 bits per byte
+
+# Length of VDU 0 - 31 including the code (23 is worked out from the next bytes)
+VDU_LEN = [1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+		   1, 2, 3, 6, 1, 1, 2, 0, 9, 6, 1, 2, 5, 5, 1, 3]
+
+VDU_27_LEN = [4, 7, 11, 7, 4, 3, 4, 4, 3, 3, 4, 3, 3, 7, 7, 3, 3]
+
+NAMES = {
+	(0,): "null", (1,): "printer char", (4,): "text at text cursor", (5,): "text at graphics cursor",
+	(7,): "bell", (8,): "cursor left", (9,): "cursor right", (10,): "cursor down", (11,): "cursor up",
+	(12,): "cls", (13,): "return", (16,): "clg", (17,): "colour", (18,): "gcol",
+	(19,): "define colour", (22,): "mode", (24,): "graphics viewport", (25,): "plot",
+	(26,): "reset viewports", (28,): "text viewport", (29,): "graphics origin", (30,): "home",
+	(31,): "tab", (32,): "text", (23, 1): "cursor on/off", (23, 32): "define character",
+	(23, 0, 0x80): "general poll", (23, 0, 0x82): "cursor position", (23, 0, 0x85): "audio",
+	(23, 0, 0x86): "mode information", (23, 0, 0x87): "rtc", (23, 0, 0xA0): "buffer",
+	(23, 0, 0xC0): "logical coordinates", (23, 0, 0xC3): "swap", (23, 27, 0): "select bitmap",
+	(23, 27, 1): "load bitmap", (23, 27, 2): "solid bitmap", (23, 27, 3): "draw bitmap",
+	(23, 27, 4): "select sprite", (23, 27, 5): "clear sprite", (23, 27, 6): "add sprite bitmap",
+	(23, 27, 7): "activate sprites", (23, 27, 8): "next sprite frame", (23, 27, 9): "previous sprite frame",
+	(23, 27, 10): "sprite frame", (23, 27, 11): "show sprite", (23, 27, 12): "hide sprite",
+	(23, 27, 13): "move sprite to", (23, 27, 14): "move sprite by", (23, 27, 15): "update sprites",
+	(23, 27, 16): "reset sprites", (23, 27, 0x20): "select bitmap (16-bit)",
+	(23, 27, 0x21): "bitmap from buffer", (23, 27, 0x26): "add sprite bitmap (16-bit)",
+}
+
+BUFFER_NAMES = {0: "write block", 2: "clear", 3: "create", 4: "stream", 5: "adjust",
+				14: "consolidate", 15: "split", 17: "split from", 20: "split by width from"}
+
+
+def key_tuple(key):
+	b = (key & 0xFF, (key >> 8) & 0xFF, key >> 16)
+	if b[0] != 23:
+		return b[:1]
+	if b[1] in (0, 27):
+		return b
+	return b[:2]
+
+
+def cmd_len(hdr):
+	c = hdr[0]
+	if c != 23:
+		return VDU_LEN[c] if c < 32 else 1
+	if len(hdr) < 2:
+		return -1
+	if hdr[1] >= 32:
+		return 10
+	if hdr[1] == 1:
+		return 3
+	if hdr[1] not in (0, 27):
+		return 0
+	if len(hdr) < 3:
+		return -1
+	if hdr[1] == 27:
+		c = hdr[2]
+		if c <= 16:
+			return VDU_27_LEN[c]
+		return {0x20: 5, 0x26: 5, 0x21: 8}.get(c, 0)
+	c = hdr[2]
+	if c == 0xA0:
+		if len(hdr) < 6:
+			return -1
+		return {0: 8, 3: 8, 15: 8, 2: 6, 4: 6, 14: 6, 17: 10, 20: 12}.get(hdr[5], 0)
+	if c == 0x85:
+		if len(hdr) < 5:
+			return -1
+		return {0: 10, 1: 5, 2: 6, 3: 7, 8: 5, 9: 5, 10: 5}.get(hdr[4], 0)
+	if c in (0x82, 0x86, 0xC3, 0xCA, 0xFF):
+		return 3
+	if c in (0x80, 0x81, 0x94, 0xC0, 0xC1, 0xFE):
+		return 4
+	if c in (0x83, 0x84):
+		return 7
+	return 0
+
+
+def decode(raw):
+	"""Yield (key, name, bytes) for each command in the raw stream.
+
+	Commands of unknown length end at the next byte that starts a known command, as the
+	write boundaries used on the Agon aren't in the stream."""
+	pos = 0
+	n = len(raw)
+	while pos < n:
+		hdr = bytearray()
+		need = -1
+		while pos < n:
+			hdr.append(raw[pos])
+			pos += 1
+			need = cmd_len(hdr)
+			if need > 0 and len(hdr) >= need:
+				break
+			if need == 0 and (len(hdr) >= 64 or (pos < n and raw[pos] in (23, 25, 22))):
+				break
+		key = (hdr[0],) if hdr[0] < 32 else (32,)
+		if hdr[0] == 23 and len(hdr) > 1:
+			key = (23, 32) if hdr[1] >= 32 else (23, hdr[1]) + ((hdr[2],) if hdr[1] in (0, 27) and len(hdr) > 2 else ())
+		name = NAMES.get(key, "")
+		data = 0
+		if key == (23, 27, 1) and len(hdr) == 7:
+			data = (hdr[3] | hdr[4] << 8) * (hdr[5] | hdr[6] << 8) * 4
+		elif key == (23, 0, 0xA0) and len(hdr) >= 6:
+			name = "buffer " + BUFFER_NAMES.get(hdr[5], str(hdr[5]))
+			key = key + (hdr[5],)
+			if hdr[5] == 0 and len(hdr) == 8:
+				data = hdr[6] | hdr[7] << 8
+		elif key == (23, 0, 0x85) and len(hdr) >= 5:
+			name = "audio command %d" % hdr[4]
+			key = key + (hdr[4],)
+		data = min(data, n - pos)
+		pos += data
+		yield key, name, len(hdr) + data
+
+
+def main():
+	parser = argparse.ArgumentParser(description="decode an Agon VDU stream capture")
+	parser.add_argument("--fps", type=int, default=60, help="frame rate, for link use per frame")
+	parser.add_argument("--frames", action="store_true", help="list every frame")
+	parser.add_argument("--dump", action="store_true", help="list every decoded command")
+	parser.add_argument("capture")
+	args = parser.parse_args()
+
+	with open(args.capture, "rb") as f:
+		data = f.read()
+	if data[:5] != MAGIC:
+		sys.exit("vducap: %s is not a capture file" % args.capture)
+
+	pos = 5
+	(nkeys,) = struct.unpack_from("<H", data, pos)
+	pos += 2
+	keys = []
+	for _ in range(nkeys):
+		key = int.from_bytes(data[pos:pos + 3], "little")
+		cmds, nbytes = struct.unpack_from("<II", data, pos + 3)
+		keys.append((key_tuple(key), cmds, nbytes))
+		pos += 11
+	nframes = int.from_bytes(data[pos:pos + 3], "little")
+	pos += 3
+	frames = []
+	for _ in range(nframes):
+		frames.append((int.from_bytes(data[pos:pos + 3], "little"), struct.unpack_from("<H", data, pos + 3)[0]))
+		pos += 5
+	(total,) = struct.unpack_from("<I", data, pos)
+	raw_len = int.from_bytes(data[pos + 4:pos + 7], "little")
+	raw = data[pos + 7:pos + 7 + raw_len]
+
+	print("%d bytes captured, %d frames%s" % (total, nframes,
+		  "" if raw_len == total else ", first %d bytes kept" % raw_len if raw_len else ""))
+
+	if raw:
+		counts = {}
+		for key, name, nbytes in decode(raw):
+			c = counts.setdefault(key, [name, 0, 0])
+			c[1] += 1
+			c[2] += nbytes
+			if args.dump:
+				print("  %-16s %-28s %6d" % (",".join(str(k) for k in key), name, nbytes))
+		rows = [(key, c[0], c[1], c[2]) for key, c in counts.items()]
+		print("\nDecoded from the raw stream:")
+	else:
+		rows = [(key, NAMES.get(key, ""), cmds, nbytes) for key, cmds, nbytes in keys]
+		print("\nCounted on the Agon:")
+
+	rows.sort(key=lambda r: -r[3])
+	grand = sum(r[3] for r in rows) or 1
+	print("  %-16s %-28s %8s %10s %6s" % ("command", "", "count", "bytes", "%"))
+	for key, name, cmds, nbytes in rows:
+		label = "(other)" if key == (0xFF, 0xFF, 0xFF) else ",".join(str(k) for k in key)
+		print("  %-16s %-28s %8d %10d %5.1f%%" % (label, name, cmds, nbytes, 100.0 * nbytes / grand))
+
+	if frames:
+		budget = LINK_BYTES_PER_SEC / args.fps
+		sizes = [b for b, _ in frames]
+		print("\nFrames: min %d, mean %.0f, max %d bytes (link allows about %.0f at %d fps)" %
+			  (min(sizes), sum(sizes) / len(sizes), max(sizes), budget, args.fps))
+		over = sum(1 for b in sizes if b > budget)
+		if over:
+			print("  %d frames over the link budget" % over)
+		if args.frames:
+			for i, (b, cmds) in enumerate(frames):
+				bar = "#" * min(60, int(60 * b / max(sizes))) if max(sizes) else ""
+				print("  %5d %7d %5d  %s" % (i, b, cmds, bar))
+
+
+if __name__ == "__main__":
+	main()